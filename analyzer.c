@@ -1,156 +1,2320 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <cjson/cJSON.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "analyzer.h"
 
-// 매크로 정의
-#define OBJ(o, key) cJSON_GetObjectItem(o, key)
-#define ARR(o, idx) cJSON_GetArrayItem(o, idx)
-#define IS_STR(n) (cJSON_IsString(n))
-#define IS_ARR(n) (cJSON_IsArray(n))
-#define ARR_SIZE(a) cJSON_GetArraySize(a)
+Func *funcs;
+int funcCnt = 0, funcCap = 0;
+
+// ===== 해시 / 문자열 맵 =====
+uint64_t hashStr(const char *s) {
+    uint64_t h = 1469598103934665603ULL; // FNV-1a
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static uint64_t hashMix(uint64_t h, uint64_t x) {
+    x *= 0x9e3779b97f4a7c15ULL;
+    x ^= x >> 29;
+    return (h ^ x) * 0xbf58476d1ce4e5b9ULL + 0x94d049bb133111ebULL;
+}
+
+static void mapGrow(StrMap *m);
+
+int mapGet(StrMap *m, const char *key) {
+    if (!m->cap) return -1;
+    for (size_t i = hashStr(key) & (m->cap - 1);; i = (i + 1) & (m->cap - 1)) {
+        if (!m->keys[i]) return -1;
+        if (!strcmp(m->keys[i], key)) return m->vals[i];
+    }
+}
+
+void mapPut(StrMap *m, const char *key, int val) {
+    if ((m->cnt + 1) * 2 > m->cap) mapGrow(m);
+    size_t i = hashStr(key) & (m->cap - 1);
+    while (m->keys[i] && strcmp(m->keys[i], key)) i = (i + 1) & (m->cap - 1);
+    if (!m->keys[i]) {
+        m->keys[i] = strdup(key);
+        m->cnt++;
+    }
+    m->vals[i] = val;
+}
+
+static void mapGrow(StrMap *m) {
+    StrMap old = *m;
+    m->cap = old.cap ? old.cap * 2 : 64;
+    m->cnt = 0;
+    m->keys = calloc(m->cap, sizeof(char *));
+    m->vals = calloc(m->cap, sizeof(int));
+    for (int i = 0; i < old.cap; i++) {
+        if (!old.keys[i]) continue;
+        mapPut(m, old.keys[i], old.vals[i]);
+        free(old.keys[i]);
+    }
+    free(old.keys);
+    free(old.vals);
+}
+
+void mapFree(StrMap *m) {
+    for (int i = 0; i < m->cap; i++) free(m->keys[i]);
+    free(m->keys);
+    free(m->vals);
+    memset(m, 0, sizeof(StrMap));
+}
+
+// ===== 타입 테이블 =====
+// 선언된 타입을 구조적으로 정규화해 해시 콘싱한다.
+// 같은 타입은 항상 같은 id를 가지므로 타입 비교는 정수 비교다.
+enum { TY_UNKNOWN, TY_BASE, TY_PTR, TY_ARRAY, TY_FUNC };
+
+#define Q_CONST    1
+#define Q_VOLATILE 2
+#define Q_RESTRICT 4
+
+#define F_VARIADIC 1    // ... 파라미터
+#define F_NOPROTO  2    // 파라미터 목록이 없는 선언: f()
+
+#define DIM_NONE   -1   // int a[]
+#define DIM_EXPR   -2   // 상수가 아닌 크기
+
+typedef struct {
+    int kind;
+    int quals;
+    int base;       // PTR: 가리키는 타입, ARRAY: 원소 타입, FUNC: 반환 타입
+    int name;       // BASE: 이름 id ("unsigned int", "struct node")
+    long dim;       // ARRAY
+    int flags;      // FUNC
+    int nparams;
+    int *params;
+    char *str;      // 출력용 문자열 (처음 요청될 때 생성)
+} Type;
+
+#define TYPE_UNKNOWN 0
+
+Type *types;
+int typeCnt, typeCap;
+static int *typeSlots;      // 해시 인덱스 (id + 1, 0 = 빈칸)
+static int typeSlotCap;
+static StrMap typeNameIds;
+static char **typeNames;
+static int typeNameCnt;
+
+static int typeNameId(const char *name) {
+    int id = mapGet(&typeNameIds, name);
+    if (id >= 0) return id;
+    typeNames = realloc(typeNames, (typeNameCnt + 1) * sizeof(char *));
+    typeNames[typeNameCnt] = strdup(name);
+    mapPut(&typeNameIds, name, typeNameCnt);
+    return typeNameCnt++;
+}
+
+static uint64_t typeHash(const Type *t) {
+    uint64_t h = hashMix(t->kind, t->quals);
+    h = hashMix(h, t->base);
+    h = hashMix(h, t->name);
+    h = hashMix(h, (uint64_t)t->dim);
+    h = hashMix(h, t->flags);
+    for (int i = 0; i < t->nparams; i++) h = hashMix(h, t->params[i]);
+    return h;
+}
+
+static int typeEq(const Type *a, const Type *b) {
+    return a->kind == b->kind && a->quals == b->quals && a->base == b->base &&
+           a->name == b->name && a->dim == b->dim && a->flags == b->flags &&
+           a->nparams == b->nparams &&
+           (!a->nparams || !memcmp(a->params, b->params, a->nparams * sizeof(int)));
+}
+
+static void typeSlotsRebuild(void) {
+    free(typeSlots);
+    typeSlotCap = typeSlotCap ? typeSlotCap * 2 : 256;
+    typeSlots = calloc(typeSlotCap, sizeof(int));
+    for (int id = 0; id < typeCnt; id++) {
+        size_t i = typeHash(&types[id]) & (typeSlotCap - 1);
+        while (typeSlots[i]) i = (i + 1) & (typeSlotCap - 1);
+        typeSlots[i] = id + 1;
+    }
+}
+
+// 같은 구조의 타입이 있으면 그 id, 없으면 새로 등록 (params는 복사)
+int typeIntern(const Type *t) {
+    if (!typeCnt) {
+        types = calloc(typeCap = 64, sizeof(Type));
+        typeCnt = 1; // 0번은 unknown
+        typeSlotsRebuild();
+    }
+
+    size_t i = typeHash(t) & (typeSlotCap - 1);
+    for (; typeSlots[i]; i = (i + 1) & (typeSlotCap - 1)) {
+        if (typeEq(&types[typeSlots[i] - 1], t)) return typeSlots[i] - 1;
+    }
+
+    if (typeCnt == typeCap) types = realloc(types, (typeCap *= 2) * sizeof(Type));
+    int id = typeCnt++;
+    types[id] = *t;
+    types[id].str = NULL;
+    if (t->nparams) {
+        types[id].params = malloc(t->nparams * sizeof(int));
+        memcpy(types[id].params, t->params, t->nparams * sizeof(int));
+    }
+    typeSlots[i] = id + 1;
+    if (typeCnt * 2 > typeSlotCap) typeSlotsRebuild();
+    return id;
+}
+
+const char *astType(cJSON *n) {
+    cJSON *t = OBJ(n, "_nodetype");
+    return t && IS_STR(t) ? t->valuestring : "";
+}
+
+static int parseQuals(cJSON *quals) {
+    int q = 0;
+    cJSON *s;
+    cJSON_ArrayForEach(s, quals) {
+        if (!IS_STR(s)) continue;
+        if (!strcmp(s->valuestring, "const")) q |= Q_CONST;
+        else if (!strcmp(s->valuestring, "volatile")) q |= Q_VOLATILE;
+        else if (!strcmp(s->valuestring, "restrict")) q |= Q_RESTRICT;
+    }
+    return q;
+}
+
+// id에 한정자를 더한 타입 (typedef 이름에 붙은 const 등)
+static int typeQualify(int id, int quals) {
+    if (!id || !quals || (types[id].quals | quals) == types[id].quals) return id;
+    Type t = types[id];
+    t.quals |= quals;
+    return typeIntern(&t);
+}
+
+// 파라미터 조정: 배열/함수는 포인터로, 최상위 한정자는 뺀다 (호환성 비교용)
+static int paramAdjust(int id) {
+    if (!id) return id;
+    Type t = {0};
+    if (types[id].kind == TY_ARRAY) {
+        t.kind = TY_PTR;
+        t.base = types[id].base;
+        return typeIntern(&t);
+    }
+    if (types[id].kind == TY_FUNC) {
+        t.kind = TY_PTR;
+        t.base = id;
+        return typeIntern(&t);
+    }
+    if (!types[id].quals) return id;
+    t = types[id];
+    t.quals = 0;
+    return typeIntern(&t);
+}
+
+// typedef 이름 -> 타입 id. TU마다 따로 ("이름@TU번호")
+static StrMap typedefIds;
+int typedefTu;
+
+static void typedefKey(const char *name, char *key, size_t n) {
+    snprintf(key, n, "%s@%d", name, typedefTu);
+}
+
+void typedefDefine(const char *name, int id) {
+    char key[300];
+    typedefKey(name, key, sizeof(key));
+    mapPut(&typedefIds, key, id);
+}
+
+// 기본 타입 지정자 묶음을 한 가지 표기로 ("long int" / "signed long" -> "long",
+// "unsigned" -> "unsigned int"). 기본 타입 키워드가 아닌 단어가 있으면 0
+static int canonBase(cJSON *names, char *out, size_t n) {
+    int sign = 0, unsign = 0, chr = 0, shrt = 0, in = 0, lng = 0, flt = 0, dbl = 0, vd = 0, bl = 0, cplx = 0;
+    if (!ARR_SIZE(names)) return 0;
+    cJSON *s;
+    cJSON_ArrayForEach(s, names) {
+        const char *w = IS_STR(s) ? s->valuestring : "";
+        if (!strcmp(w, "signed")) sign++;
+        else if (!strcmp(w, "unsigned")) unsign++;
+        else if (!strcmp(w, "char")) chr++;
+        else if (!strcmp(w, "short")) shrt++;
+        else if (!strcmp(w, "int")) in++;
+        else if (!strcmp(w, "long")) lng++;
+        else if (!strcmp(w, "float")) flt++;
+        else if (!strcmp(w, "double")) dbl++;
+        else if (!strcmp(w, "void")) vd++;
+        else if (!strcmp(w, "_Bool")) bl++;
+        else if (!strcmp(w, "_Complex")) cplx++;
+        else return 0;
+    }
+    const char *base;
+    if (vd) base = "void";
+    else if (bl) base = "_Bool";
+    else if (flt) base = "float";
+    else if (dbl) base = lng ? "long double" : "double";
+    else if (chr) base = unsign ? "unsigned char" : sign ? "signed char" : "char";
+    else if (shrt) base = "short";
+    else if (lng >= 2) base = "long long";
+    else if (lng) base = "long";
+    else base = "int";
+    (void)in;
+    int isInt = !(vd || bl || flt || dbl || chr);
+    snprintf(out, n, "%s%s%s", unsign && isInt ? "unsigned " : "", base, cplx ? " _Complex" : "");
+    return 1;
+}
+
+int resolveType(cJSON *n);
+
+// 이름 없는 태그의 구별 번호. 선언 위치는 프론트엔드마다 열이 달라서 쓰지 않고
+// 멤버 구성(이름, 타입 id, 비트 폭 / 열거자 이름)이 같으면 같은 번호
+static StrMap anonIds;
+
+static long anonId(cJSON *n, const char *kw) {
+    char key[4096];
+    size_t len = snprintf(key, sizeof(key), "%s{", kw);
+    cJSON *m;
+    cJSON_ArrayForEach(m, OBJ(n, "decls")) {
+        cJSON *name = OBJ(m, "name"), *bits = OBJ(OBJ(m, "bitsize"), "value");
+        if (len >= sizeof(key)) break;
+        len += snprintf(key + len, sizeof(key) - len, "%s:%d:%s;", IS_STR(name) ? name->valuestring : "",
+                        resolveType(m), IS_STR(bits) ? bits->valuestring : "");
+    }
+    cJSON_ArrayForEach(m, OBJ(OBJ(n, "values"), "enumerators")) {
+        cJSON *name = OBJ(m, "name");
+        if (len >= sizeof(key)) break;
+        len += snprintf(key + len, sizeof(key) - len, "%s;", IS_STR(name) ? name->valuestring : "");
+    }
+    int id = mapGet(&anonIds, key);
+    if (id < 0) mapPut(&anonIds, key, id = anonIds.cnt + 1);
+    return id;
+}
+
+// IdentifierType / Struct / Union / Enum
+static int resolveBase(cJSON *n, int quals) {
+    const char *nt = astType(n);
+    char name[256] = "";
+    long anon = 0;
+
+    if (!strcmp(nt, "IdentifierType")) {
+        cJSON *names = OBJ(n, "names");
+        if (!canonBase(names, name, sizeof(name))) {
+            cJSON *s;
+            cJSON_ArrayForEach(s, names) {
+                if (!IS_STR(s)) continue;
+                size_t len = strlen(name);
+                snprintf(name + len, sizeof(name) - len, "%s%s", len ? " " : "", s->valuestring);
+            }
+        }
+        if (ARR_SIZE(names) == 1) {
+            char key[300];
+            typedefKey(name, key, sizeof(key));
+            int id = mapGet(&typedefIds, key);
+            if (id >= 0) return typeQualify(id, quals);
+        }
+    } else if (!strcmp(nt, "Struct") || !strcmp(nt, "Union") || !strcmp(nt, "Enum")) {
+        cJSON *tag = OBJ(n, "name");
+        const char *kw = !strcmp(nt, "Struct") ? "struct" : !strcmp(nt, "Union") ? "union" : "enum";
+        if (tag && IS_STR(tag)) {
+            snprintf(name, sizeof(name), "%s %s", kw, tag->valuestring);
+        } else {
+            // 이름 없는 태그는 출력 이름이 같고 dim에 둔 구별 번호로 서로 다른 타입
+            snprintf(name, sizeof(name), "%s <anonymous>", kw);
+            anon = anonId(n, kw);
+        }
+    }
+    if (!name[0]) return TYPE_UNKNOWN;
+
+    Type t = {0};
+    t.kind = TY_BASE;
+    t.quals = quals;
+    t.name = typeNameId(name);
+    t.dim = anon;
+    return typeIntern(&t);
+}
+
+// 선언자 체인 (TypeDecl/PtrDecl/ArrayDecl/FuncDecl, Decl/Typename) -> 타입 id
+int resolveType(cJSON *n) {
+    if (!n) return TYPE_UNKNOWN;
+    const char *nt = astType(n);
+    Type t = {0};
+
+    if (!strcmp(nt, "Decl") || !strcmp(nt, "Typename") || !strcmp(nt, "Typedef")) {
+        return resolveType(OBJ(n, "type"));
+    } else if (!strcmp(nt, "TypeDecl")) {
+        return resolveBase(OBJ(n, "type"), parseQuals(OBJ(n, "quals")));
+    } else if (!strcmp(nt, "PtrDecl")) {
+        t.kind = TY_PTR;
+        t.quals = parseQuals(OBJ(n, "quals"));
+        t.base = resolveType(OBJ(n, "type"));
+    } else if (!strcmp(nt, "ArrayDecl")) {
+        t.kind = TY_ARRAY;
+        t.quals = parseQuals(OBJ(n, "dim_quals"));
+        t.base = resolveType(OBJ(n, "type"));
+        cJSON *dim = OBJ(n, "dim");
+        cJSON *v = OBJ(dim, "value");
+        if (!dim || cJSON_IsNull(dim)) t.dim = DIM_NONE;
+        else if (!strcmp(astType(dim), "Constant") && IS_STR(v)) t.dim = strtol(v->valuestring, NULL, 0);
+        else t.dim = DIM_EXPR;
+    } else if (!strcmp(nt, "FuncDecl")) {
+        t.kind = TY_FUNC;
+        t.base = resolveType(OBJ(n, "type"));
+
+        cJSON *args = OBJ(n, "args");
+        cJSON *params = OBJ(args, "params");
+        if (!IS_ARR(params) || !strcmp(astType(ARR(params, 0)), "ID")) {
+            // f()와 K&R 식별자 목록 f(a, b)는 프로토타입이 아니다
+            t.flags |= F_NOPROTO;
+        } else {
+            t.params = malloc((ARR_SIZE(params) + 1) * sizeof(int));
+            cJSON *p;
+            cJSON_ArrayForEach(p, params) {
+                if (!strcmp(astType(p), "EllipsisParam")) t.flags |= F_VARIADIC;
+                else t.params[t.nparams++] = paramAdjust(resolveType(p));
+            }
+            // f(void)는 파라미터 0개
+            static int voidId = -1;
+            if (voidId < 0) {
+                Type v = {0};
+                v.kind = TY_BASE;
+                v.name = typeNameId("void");
+                voidId = typeIntern(&v);
+            }
+            if (t.nparams == 1 && t.params[0] == voidId) t.nparams = 0;
+        }
+        int id = typeIntern(&t);
+        free(t.params);
+        return id;
+    } else {
+        return resolveBase(n, 0);
+    }
+    return typeIntern(&t);
+}
+
+static void quals2str(int q, char *buf, size_t n) {
+    snprintf(buf, n, "%s%s%s", q & Q_CONST ? "const " : "", q & Q_VOLATILE ? "volatile " : "",
+             q & Q_RESTRICT ? "restrict " : "");
+}
+
+const char *typeStr(int id);
+
+// decl을 선언자로 삼아 C 문법대로 출력 ("int (*f)(char *)")
+static void typeRender(int id, const char *decl, char *out, size_t n) {
+    Type *t = &types[id];
+    char q[32], nd[512];
+    quals2str(t->quals, q, sizeof(q));
+
+    switch (id ? t->kind : TY_UNKNOWN) {
+    case TY_BASE:
+        snprintf(out, n, "%s%s%s%s", q, typeNames[t->name], decl[0] ? " " : "", decl);
+        return;
+    case TY_PTR: {
+        int wrap = types[t->base].kind == TY_ARRAY || types[t->base].kind == TY_FUNC;
+        size_t ql = strlen(q);
+        if (ql && decl[0]) q[ql - 1] = ' ';
+        else if (ql) q[ql - 1] = '\0';
+        snprintf(nd, sizeof(nd), "%s*%s%s%s", wrap ? "(" : "", q, decl, wrap ? ")" : "");
+        typeRender(t->base, nd, out, n);
+        return;
+    }
+    case TY_ARRAY:
+        if (t->dim >= 0) snprintf(nd, sizeof(nd), "%s[%ld]", decl, t->dim);
+        else snprintf(nd, sizeof(nd), "%s[%s]", decl, t->dim == DIM_EXPR ? "*" : "");
+        typeRender(t->base, nd, out, n);
+        return;
+    case TY_FUNC: {
+        size_t len = snprintf(nd, sizeof(nd), "%s(", decl);
+        for (int i = 0; i < t->nparams && len < sizeof(nd); i++) {
+            len += snprintf(nd + len, sizeof(nd) - len, "%s%s", i ? ", " : "", typeStr(t->params[i]));
+        }
+        if (len < sizeof(nd)) {
+            const char *tail = t->flags & F_VARIADIC ? (t->nparams ? ", ...)" : "...)")
+                             : !t->nparams && !(t->flags & F_NOPROTO) ? "void)" : ")";
+            snprintf(nd + len, sizeof(nd) - len, "%s", tail);
+        }
+        typeRender(t->base, nd, out, n);
+        return;
+    }
+    default:
+        snprintf(out, n, "unknown%s%s", decl[0] ? " " : "", decl);
+    }
+}
+
+const char *typeStr(int id) {
+    if (!typeCnt) return "unknown";
+    if (!types[id].str) {
+        char buf[512];
+        typeRender(id, "", buf, sizeof(buf));
+        types[id].str = strdup(buf);
+    }
+    return types[id].str;
+}
+
+// 이름을 붙인 선언 형태 ("char *old")
+void typeDecl(int id, const char *name, char *buf, size_t n) {
+    if (!typeCnt) snprintf(buf, n, "unknown %s", name);
+    else typeRender(id, name, buf, n);
+}
+
+// K&R 파라미터 name의 타입: 정의의 param_decls에서 찾고, 없으면 암시적 int
+static int knrParamType(cJSON *paramDecls, const char *name) {
+    cJSON *d;
+    cJSON_ArrayForEach(d, paramDecls) {
+        cJSON *dn = OBJ(d, "name");
+        if (IS_STR(dn) && !strcmp(dn->valuestring, name)) return resolveType(d);
+    }
+    Type t = {0};
+    t.kind = TY_BASE;
+    t.name = typeNameId("int");
+    return typeIntern(&t);
+}
+
+// decl 노드에서 이름/반환 타입/파라미터를 채운다.
+// paramDecls는 K&R 정의의 param_decls (없으면 NULL)
+int parseFunc(cJSON *decl, cJSON *paramDecls, Func *f) {
+    if (!decl) return 0;
+
+    memset(f, 0, sizeof(Func));
+
+    cJSON *name = OBJ(decl, "name");
+    f->name = name ? strdup(name->valuestring) : strdup("unknown");
+
+    cJSON *type = OBJ(decl, "type");
+    f->type = resolveType(type);
+    Type *ft = &types[f->type];
+    if (ft->kind != TY_FUNC) return 1;
+    f->retType = ft->base;
+
+    // 정규화된 파라미터 목록 기준 (f(void)는 0개, ...은 제외).
+    // 출력용 파라미터 타입은 조정 전 선언 그대로
+    // K&R 식별자 목록은 이름만 있으니 타입은 paramDecls에서
+    cJSON *params = OBJ(OBJ(type, "args"), "params");
+    int knr = !strcmp(astType(ARR(params, 0)), "ID");
+    int nparams = knr ? ARR_SIZE(params) : ft->nparams;
+    for (int i = 0; i < nparams && i < 10; i++) {
+        cJSON *pn = OBJ(ARR(params, i), "name");
+        f->args[i].type = !knr ? resolveType(ARR(params, i))
+                        : IS_STR(pn) ? knrParamType(paramDecls, pn->valuestring) : TYPE_UNKNOWN;
+        f->args[i].name = strdup(pn && IS_STR(pn) ? pn->valuestring : "arg");
+        f->argc++;
+    }
+
+    return 1;
+}
+
+void freeFunc(Func *f) {
+    free(f->name);
+    for (int i = 0; i < f->argc; i++) {
+        free(f->args[i].name);
+    }
+}
+
+// ===== 패스 API =====
+// 패스는 방문할 노드 타입과 enter/exit 콜백, 함수별 상태 크기를 선언한다.
+// 등록된 패스들은 함수 본문 한 번의 순회로 합쳐지고, 각 노드는
+// 그 타입을 선언한 패스에만 전달된다.
+typedef struct {
+    const char *name;
+    const char *const *visits;  // 방문할 노드 타입 (NULL 끝). NULL이면 모든 노드
+    size_t stateSize;           // 함수마다 0으로 초기화해 넘겨준다
+    void (*begin)(void *st, Func *f, cJSON *def);
+    void (*enter)(void *st, cJSON *node);
+    void (*exit)(void *st, cJSON *node);
+    void (*end)(void *st, Func *f, cJSON *def);
+} Pass;
+
+#define MAX_PASSES 64
+
+static const Pass *passes[MAX_PASSES];
+static int passCnt;
+static StrMap passKinds;        // 노드 타입 -> passMasks 인덱스
+static uint64_t *passMasks;     // 노드 타입별 관심 있는 패스 비트
+static uint64_t passAll;        // 모든 노드를 보는 패스
+
+int registerPass(const Pass *p) {
+    if (passCnt == MAX_PASSES) return 0;
+    uint64_t bit = 1ULL << passCnt;
+    passes[passCnt++] = p;
+
+    if (!p->visits) {
+        passAll |= bit;
+        return 1;
+    }
+    for (const char *const *t = p->visits; *t; t++) {
+        int k = mapGet(&passKinds, *t);
+        if (k < 0) {
+            k = passKinds.cnt;
+            mapPut(&passKinds, *t, k);
+            passMasks = realloc(passMasks, (k + 1) * sizeof(uint64_t));
+            passMasks[k] = 0;
+        }
+        passMasks[k] |= bit;
+    }
+    return 1;
+}
+
+static void passWalk(cJSON *n, void **st) {
+    uint64_t m = 0;
+    cJSON *nt = cJSON_IsObject(n) ? OBJ(n, "_nodetype") : NULL;
+    if (IS_STR(nt)) {
+        int k = mapGet(&passKinds, nt->valuestring);
+        m = passAll | (k >= 0 ? passMasks[k] : 0);
+    }
+
+    for (uint64_t b = m; b; b &= b - 1) {
+        int i = __builtin_ctzll(b);
+        if (passes[i]->enter) passes[i]->enter(st[i], n);
+    }
+
+    cJSON *k;
+    cJSON_ArrayForEach(k, n) {
+        if (cJSON_IsObject(k) || IS_ARR(k)) passWalk(k, st);
+    }
+
+    // exit은 enter의 역순
+    for (uint64_t b = m; b; b &= ~(1ULL << (63 - __builtin_clzll(b)))) {
+        int i = 63 - __builtin_clzll(b);
+        if (passes[i]->exit) passes[i]->exit(st[i], n);
+    }
+}
+
+// 등록된 모든 패스를 FuncDef 하나에 대해 한 번의 순회로 실행
+void runPasses(Func *f, cJSON *def) {
+    void *st[MAX_PASSES];
+    for (int i = 0; i < passCnt; i++) {
+        st[i] = passes[i]->stateSize ? calloc(1, passes[i]->stateSize) : NULL;
+        if (passes[i]->begin) passes[i]->begin(st[i], f, def);
+    }
+
+    passWalk(OBJ(def, "body"), st);
+
+    for (int i = 0; i < passCnt; i++) {
+        if (passes[i]->end) passes[i]->end(st[i], f, def);
+        free(st[i]);
+    }
+}
+
+// if문 개수
+static void ifBegin(void *st, Func *f, cJSON *def) {
+    (void)def;
+    *(Func **)st = f;
+}
+
+static void ifEnter(void *st, cJSON *node) {
+    (void)node;
+    (*(Func **)st)->ifs++;
+}
+
+static const char *const ifVisits[] = {"If", NULL};
+const Pass ifPass = {"if-count", ifVisits, sizeof(Func *), ifBegin, ifEnter, NULL, NULL};
+
+// ext 항목이 함수(프로토타입/정의)면 f를 채우고 1 반환
+int extFunc(cJSON *node, Func *f) {
+    cJSON *nt = OBJ(node, "_nodetype");
+    if (!nt || !IS_STR(nt)) return 0;
+
+    if (!strcmp(nt->valuestring, "Decl")) {
+        cJSON *t = OBJ(node, "type");
+        cJSON *inner = t ? OBJ(t, "_nodetype") : NULL;
+        if (inner && !strcmp(inner->valuestring, "FuncDecl")) {
+            return parseFunc(node, NULL, f);
+        }
+    } else if (!strcmp(nt->valuestring, "FuncDef")) {
+        if (!parseFunc(OBJ(node, "decl"), OBJ(node, "param_decls"), f)) return 0;
+        f->defined = 1;
+        runPasses(f, node);
+        return 1;
+    }
+    return 0;
+}
+
+// ===== 전역 변수 부작용 요약 =====
+// 함수마다 직접 읽고/쓰는 전역 변수를 비트셋(전역 id 인덱스)으로 모으고,
+// 호출 그래프를 따라 고정점까지 OR로 전파한다.
+static void bitsGrow(Bits *b, int words) {
+    if (words <= b->n) return;
+    b->w = realloc(b->w, words * sizeof(uint64_t));
+    memset(b->w + b->n, 0, (words - b->n) * sizeof(uint64_t));
+    b->n = words;
+}
+
+static void bitSet(Bits *b, int i) {
+    bitsGrow(b, i / 64 + 1);
+    b->w[i / 64] |= 1ULL << (i % 64);
+}
+
+// a |= b, 바뀌었으면 1
+static int bitsOr(Bits *a, const Bits *b) {
+    bitsGrow(a, b->n);
+    uint64_t changed = 0;
+    for (int i = 0; i < b->n; i++) {
+        uint64_t x = a->w[i] | b->w[i];
+        changed |= x ^ a->w[i];
+        a->w[i] = x;
+    }
+    return changed != 0;
+}
+
+StrMap globalIds;
+char **globalNames;
+int *globalTypes;
+int globalCnt;
+
+static StrMap effIds;
+Effects *effs;
+int effCnt;
+
+void addGlobal(const char *name, int type) {
+    if (mapGet(&globalIds, name) >= 0) return; // extern 선언 후 정의 등
+    globalNames = realloc(globalNames, (globalCnt + 1) * sizeof(char *));
+    globalTypes = realloc(globalTypes, (globalCnt + 1) * sizeof(int));
+    globalNames[globalCnt] = strdup(name);
+    globalTypes[globalCnt] = type;
+    mapPut(&globalIds, name, globalCnt++);
+}
+
+static int effId(const char *name) {
+    int id = mapGet(&effIds, name);
+    if (id >= 0) return id;
+    effs = realloc(effs, (effCnt + 1) * sizeof(Effects));
+    memset(&effs[effCnt], 0, sizeof(Effects));
+    effs[effCnt].name = strdup(name);
+    mapPut(&effIds, name, effCnt);
+    return effCnt++;
+}
+
+typedef struct {
+    const char *name;
+    int global;             // 블록 안 extern 선언: 바깥 지역 변수를 가리고 전역을 다시 드러낸다
+} Local;
+
+typedef struct {
+    int self;               // effs 인덱스 (effs는 realloc될 수 있다)
+    Local *locals;          // 블록 스코프 스택
+    int nlocals, localCap;
+    int *marks;             // Compound/For 진입 시점의 nlocals
+    int nmarks, markCap;
+    cJSON **skips;          // 읽기로 세지 않을 ID (단순 대입의 lvalue, 필드명, 호출 함수명)
+    int nskips, skipCap;
+    int typeDepth;          // 선언자/구조체 정의 안 (파라미터/필드는 지역 변수가 아니다)
+} EffState;
+
+// 지역 변수가 가리고 있지 않은 전역이면 그 id, 아니면 -1
+static int globalOf(EffState *c, cJSON *id) {
+    cJSON *name = OBJ(id, "name");
+    if (!IS_STR(name)) return -1;
+    for (int i = c->nlocals - 1; i >= 0; i--) {
+        if (!strcmp(c->locals[i].name, name->valuestring)) {
+            return c->locals[i].global ? mapGet(&globalIds, name->valuestring) : -1;
+        }
+    }
+    return mapGet(&globalIds, name->valuestring);
+}
+
+// 대입으로 저장 공간 자체가 바뀌는 변수의 ID 노드. 포인터를 통한 쓰기면 NULL
+static cJSON *lvalueRoot(EffState *c, cJSON *lv) {
+    const char *nt = astType(lv);
+    if (!strcmp(nt, "ID")) return lv;
+    if (!strcmp(nt, "ArrayRef")) {
+        // 배열 원소 쓰기는 배열 변수 자체의 쓰기, 포인터 인덱싱은 아님
+        cJSON *r = lvalueRoot(c, OBJ(lv, "name"));
+        int g = r ? globalOf(c, r) : -1;
+        return g >= 0 && types[globalTypes[g]].kind == TY_ARRAY ? r : NULL;
+    }
+    if (!strcmp(nt, "StructRef")) {
+        cJSON *op = OBJ(lv, "type");
+        return IS_STR(op) && !strcmp(op->valuestring, ".") ? lvalueRoot(c, OBJ(lv, "name")) : NULL;
+    }
+    return NULL;
+}
+
+static void markWrite(EffState *c, cJSON *lv) {
+    cJSON *r = lvalueRoot(c, lv);
+    int g = r ? globalOf(c, r) : -1;
+    if (g >= 0) bitSet(&effs[c->self].wr, g);
+}
+
+static void effBegin(void *st, Func *f, cJSON *def) {
+    EffState *c = st;
+    c->self = effId(f->name);
+    effs[c->self].defined = 1;
+
+    cJSON *p;
+    cJSON_ArrayForEach(p, OBJ(OBJ(OBJ(OBJ(def, "decl"), "type"), "args"), "params")) {
+        cJSON *pn = OBJ(p, "name");
+        if (IS_STR(pn)) PUSH(c->locals, c->nlocals, c->localCap, ((Local){pn->valuestring, 0}));
+    }
+}
+
+static void effEnter(void *st, cJSON *n) {
+    EffState *c = st;
+    const char *nt = astType(n);
+
+    if (!strcmp(nt, "ID")) {
+        for (int i = 0; i < c->nskips; i++) {
+            if (c->skips[i] == n) return;
+        }
+        int g = globalOf(c, n);
+        if (g >= 0) bitSet(&effs[c->self].rd, g);
+    } else if (!strcmp(nt, "Compound") || !strcmp(nt, "For")) {
+        PUSH(c->marks, c->nmarks, c->markCap, c->nlocals);
+    } else if (!strcmp(nt, "FuncDecl") || !strcmp(nt, "Struct") || !strcmp(nt, "Union")) {
+        c->typeDepth++;
+    } else if (!strcmp(nt, "Assignment")) {
+        cJSON *lv = OBJ(n, "lvalue");
+        cJSON *op = OBJ(n, "op");
+        markWrite(c, lv);
+        // 단순 대입이면 lvalue 변수 자체는 읽지 않는다
+        cJSON *skip = IS_STR(op) && !strcmp(op->valuestring, "=") ? lvalueRoot(c, lv) : NULL;
+        PUSH(c->skips, c->nskips, c->skipCap, skip);
+    } else if (!strcmp(nt, "UnaryOp")) {
+        cJSON *op = OBJ(n, "op");
+        // ++/--, 그리고 주소를 넘기는 &는 쓰기로 본다
+        if (IS_STR(op) && (strstr(op->valuestring, "++") || strstr(op->valuestring, "--") ||
+                           !strcmp(op->valuestring, "&"))) {
+            markWrite(c, OBJ(n, "expr"));
+        }
+    } else if (!strcmp(nt, "StructRef")) {
+        PUSH(c->skips, c->nskips, c->skipCap, OBJ(n, "field")); // field는 변수가 아니다
+    } else if (!strcmp(nt, "FuncCall")) {
+        // 직접 호출만 간선으로. 함수 포인터 변수 호출은 그 변수의 읽기
+        cJSON *fn = OBJ(n, "name");
+        cJSON *skip = NULL;
+        if (!strcmp(astType(fn), "ID") && globalOf(c, fn) < 0) {
+            int callee = effId(OBJ(fn, "name")->valuestring);
+            Effects *e = &effs[c->self];
+            PUSH(e->callees, e->ncallees, e->calleeCap, callee);
+            skip = fn;
+        }
+        PUSH(c->skips, c->nskips, c->skipCap, skip);
+    }
+}
+
+static void effExit(void *st, cJSON *n) {
+    EffState *c = st;
+    const char *nt = astType(n);
+
+    if (!strcmp(nt, "Compound") || !strcmp(nt, "For")) {
+        c->nlocals = c->marks[--c->nmarks];
+    } else if (!strcmp(nt, "FuncDecl") || !strcmp(nt, "Struct") || !strcmp(nt, "Union")) {
+        c->typeDepth--;
+    } else if (!strcmp(nt, "Decl")) {
+        // 초기화식을 다 본 뒤부터 지역 변수. 함수 선언은 변수가 아니고,
+        // extern 선언은 전역을 가리키므로 지역으로 세지 않는다
+        cJSON *name = OBJ(n, "name");
+        cJSON *type = OBJ(n, "type");
+        if (c->typeDepth || !IS_STR(name) || !strcmp(astType(type), "FuncDecl")) return;
+        int ext = 0;
+        cJSON *st;
+        cJSON_ArrayForEach(st, OBJ(n, "storage")) {
+            ext |= IS_STR(st) && !strcmp(st->valuestring, "extern");
+        }
+        if (ext) addGlobal(name->valuestring, resolveType(type)); // 파일 범위 선언이 뒤에 나와도 추적
+        PUSH(c->locals, c->nlocals, c->localCap, ((Local){name->valuestring, ext}));
+    } else if (!strcmp(nt, "Assignment") || !strcmp(nt, "StructRef") || !strcmp(nt, "FuncCall")) {
+        c->nskips--;
+    }
+}
+
+static void effEnd(void *st, Func *f, cJSON *def) {
+    (void)f;
+    (void)def;
+    EffState *c = st;
+    free(c->locals);
+    free(c->marks);
+    free(c->skips);
+}
+
+static const char *const effVisits[] = {
+    "ID", "Compound", "For", "Decl", "FuncDecl", "Struct", "Union",
+    "Assignment", "UnaryOp", "StructRef", "FuncCall", NULL,
+};
+const Pass effectsPass = {"global-effects", effVisits, sizeof(EffState), effBegin, effEnter, effExit, effEnd};
+
+// 호출자 쪽으로 워크리스트 전파. 피호출자 집합이 커질 때만 호출자를 다시 본다
+void propagateEffects(void) {
+    int words = (globalCnt + 63) / 64;
+    int *ncallers = calloc(effCnt + 1, sizeof(int));
+    for (int f = 0; f < effCnt; f++) {
+        bitsGrow(&effs[f].rd, words);
+        bitsGrow(&effs[f].wr, words);
+        for (int i = 0; i < effs[f].ncallees; i++) ncallers[effs[f].callees[i] + 1]++;
+    }
+
+    // CSR 형태의 역방향 간선
+    for (int f = 0; f < effCnt; f++) ncallers[f + 1] += ncallers[f];
+    int *callers = malloc((ncallers[effCnt] + 1) * sizeof(int));
+    int *fill = calloc(effCnt + 1, sizeof(int));
+    for (int f = 0; f < effCnt; f++) {
+        for (int i = 0; i < effs[f].ncallees; i++) {
+            int g = effs[f].callees[i];
+            callers[ncallers[g] + fill[g]++] = f;
+        }
+    }
+
+    int *work = malloc((effCnt + 1) * sizeof(int));
+    char *queued = malloc(effCnt + 1);
+    int top = 0;
+    for (int f = 0; f < effCnt; f++) {
+        work[top++] = f;
+        queued[f] = 1;
+    }
+    while (top) {
+        int g = work[--top];
+        queued[g] = 0;
+        for (int i = ncallers[g]; i < ncallers[g + 1]; i++) {
+            int f = callers[i];
+            int changed = bitsOr(&effs[f].rd, &effs[g].rd);
+            changed |= bitsOr(&effs[f].wr, &effs[g].wr);
+            if (changed && !queued[f]) {
+                work[top++] = f;
+                queued[f] = 1;
+            }
+        }
+    }
+
+    free(ncallers);
+    free(callers);
+    free(fill);
+    free(work);
+    free(queued);
+}
+
+const Effects *effectsOf(const char *name) {
+    int id = mapGet(&effIds, name);
+    return id >= 0 && effs[id].defined ? &effs[id] : NULL;
+}
+
+// 예산 모드: ext 하나의 요약을 레코드로 옮긴 뒤 비운다
+void effReset(void) {
+    for (int i = 0; i < effCnt; i++) {
+        free(effs[i].name);
+        free(effs[i].rd.w);
+        free(effs[i].wr.w);
+        free(effs[i].callees);
+    }
+    free(effs);
+    effs = NULL;
+    effCnt = 0;
+    mapFree(&effIds);
+}
+
+static void printGlobals(const char *label, const Bits *b) {
+    printf("  - %s:", label);
+    int any = 0;
+    for (int i = 0; i < b->n; i++) {
+        for (uint64_t w = b->w[i]; w; w &= w - 1) {
+            printf("%s %s", any++ ? "," : "", globalNames[i * 64 + __builtin_ctzll(w)]);
+        }
+    }
+    printf("%s\n", any ? "" : " 없음");
+}
+
+// ===== 클론 탐지 =====
+// 노드 라벨(타입과 연산자 등, 식별자 이름/상수값은 빼고 정규화)로 높이 2짜리
+// 서브트리 해시를 만들어 싱글로 쓴다. 함수와 큰 제어문 블록마다 MinHash
+// 스케치를 만들고, 후보 쌍은 LSH 밴드 버킷에서만 뽑아 전체 쌍 비교를 피한다.
+#define CLONE_BANDS 16          // LSH 밴드 수 (밴드당 CLONE_K / CLONE_BANDS 행)
+#define CLONE_BUCKET_MAX 64     // 이보다 큰 버킷은 대표(첫 단위)와만 비교
+#define CLONE_THRESHOLD 0.6     // 추정 자카드 유사도 하한
+
+CloneUnit *cloneUnits;
+int cloneCnt, cloneCap;
+static int cloneFns;
+
+// 스케치는 단위와 따로 cloneMh[u - cloneBase]에 둔다. 예산 모드에서는 ext 하나를
+// 마칠 때마다 임시 파일로 내보내고 cloneBase를 올린다
+uint64_t (*cloneMh)[CLONE_K];
+int cloneBase;
+static int cloneMhCap;
+
+// 단위 u의 스케치. 내보낸 단위면 buf에 읽어 온다
+static const uint64_t *cloneSketch(int u, uint64_t *buf) {
+    return u >= cloneBase ? cloneMh[u - cloneBase] : spillSketch(u, buf);
+}
+
+// 출력용 함수 이름/위치. 내보낸 단위면 다음 호출 전까지만 유효
+void cloneWhere(int u, const char **func, const char **coord) {
+    if (u >= cloneBase) {
+        *func = cloneUnits[u].func;
+        *coord = cloneUnits[u].coord;
+    } else {
+        spillCloneWhere(u, func, coord);
+    }
+}
+
+typedef struct {
+    uint64_t label;
+    uint64_t acc1, acc2;    // 자식 라벨 / 자식 높이1 해시를 섞은 값
+    int kids;
+    int unit;               // 이 노드가 연 단위, 없으면 -1
+} CloneFrame;
+
+typedef struct {
+    CloneFrame *stack;
+    int depth, stackCap;
+    int *open;              // 열려 있는 단위 (바깥쪽부터)
+    int nopen, openCap;
+    int fn, order;
+} CloneState;
+
+static const char *const cloneKinds[] = {"If", "While", "DoWhile", "For", "Switch", NULL};
+
+// 이름/값/위치를 뺀 노드 라벨
+static uint64_t cloneLabel(cJSON *n) {
+    uint64_t h = hashStr(astType(n));
+    cJSON *k;
+    cJSON_ArrayForEach(k, n) {
+        if (!strcmp(k->string, "_nodetype") || !strcmp(k->string, "coord") || !strcmp(k->string, "name") ||
+            !strcmp(k->string, "declname") || !strcmp(k->string, "value")) {
+            continue;
+        }
+        if (IS_STR(k)) h = hashMix(h, hashStr(k->valuestring));
+    }
+    return h;
+}
+
+static int cloneOpen(CloneState *c, const char *func, const char *kind, cJSON *node) {
+    if (cloneCnt == cloneCap) {
+        cloneCap = cloneCap ? cloneCap * 2 : 64;
+        cloneUnits = realloc(cloneUnits, cloneCap * sizeof(CloneUnit));
+    }
+    if (cloneCnt - cloneBase == cloneMhCap) {
+        cloneMhCap = cloneMhCap ? cloneMhCap * 2 : 64;
+        cloneMh = realloc(cloneMh, cloneMhCap * sizeof(*cloneMh));
+    }
+    CloneUnit *u = &cloneUnits[cloneCnt];
+    cJSON *coord = OBJ(node, "coord");
+    u->func = strdup(func);
+    u->kind = kind;
+    u->coord = strdup(IS_STR(coord) ? coord->valuestring : "?");
+    u->fn = c->fn;
+    u->parent = c->nopen ? c->open[c->nopen - 1] : -1;
+    u->pre = c->order;
+    u->post = c->order;
+    u->nshingles = 0;
+    memset(cloneMh[cloneCnt - cloneBase], 0xff, sizeof(*cloneMh));
+    PUSH(c->open, c->nopen, c->openCap, cloneCnt);
+    return cloneCnt++;
+}
+
+static void cloneBegin(void *st, Func *f, cJSON *def) {
+    CloneState *c = st;
+    c->fn = cloneFns++;
+    cloneOpen(c, f->name, "FuncDef", def);
+}
+
+static void cloneEnter(void *st, cJSON *n) {
+    CloneState *c = st;
+    const char *nt = astType(n);
+    CloneFrame fr = {cloneLabel(n), 0, 0, 0, -1};
+    fr.acc1 = fr.acc2 = fr.label;
+    c->order++;
+    for (const char *const *k = cloneKinds; *k; k++) {
+        if (!strcmp(nt, *k)) {
+            // 찾은 cloneKinds 원소를 그대로 쓴다 (노드 문자열은 나중에 해제된다)
+            fr.unit = cloneOpen(c, cloneUnits[c->open[0]].func, *k, n);
+            break;
+        }
+    }
+    PUSH(c->stack, c->depth, c->stackCap, fr);
+}
+
+static void cloneExit(void *st, cJSON *n) {
+    (void)n;
+    CloneState *c = st;
+    CloneFrame fr = c->stack[--c->depth];
+    if (c->depth) {
+        CloneFrame *p = &c->stack[c->depth - 1];
+        p->acc1 = hashMix(p->acc1, fr.label);
+        p->acc2 = hashMix(p->acc2, fr.acc1);
+        p->kids++;
+    }
+
+    // 자식이 있는 노드마다 싱글 하나. 열린 단위 모두의 스케치에 반영
+    if (fr.kids) {
+        uint64_t v[CLONE_K];
+        for (int i = 0; i < CLONE_K; i++) v[i] = hashMix(fr.acc2, i + 1);
+        for (int j = 0; j < c->nopen; j++) {
+            uint64_t *mh = cloneMh[c->open[j] - cloneBase];
+            for (int i = 0; i < CLONE_K; i++) {
+                if (v[i] < mh[i]) mh[i] = v[i];
+            }
+            cloneUnits[c->open[j]].nshingles++;
+        }
+    }
+
+    if (fr.unit >= 0) {
+        cloneUnits[fr.unit].post = c->order;
+        c->nopen--;
+    }
+}
+
+static void cloneEnd(void *st, Func *f, cJSON *def) {
+    (void)f;
+    (void)def;
+    CloneState *c = st;
+    cloneUnits[c->open[0]].post = c->order;
+    free(c->stack);
+    free(c->open);
+}
+
+const Pass clonePass = {"clone-sketch", NULL, sizeof(CloneState), cloneBegin, cloneEnter, cloneExit, cloneEnd};
+
+typedef struct {
+    uint64_t key;
+    int unit;
+} CloneBucket;
+
+typedef struct {
+    int *units;     // 단위 번호 (오름차순)
+    int n;
+    int same;       // 클래스 안에서 확인한 가장 낮은 MinHash 일치 수
+} CloneClass;
+
+static int cmpBucket(const void *x, const void *y) {
+    const CloneBucket *a = x, *b = y;
+    if (a->key != b->key) return a->key < b->key ? -1 : 1;
+    return a->unit - b->unit;
+}
+
+// a가 b를 감싸거나 같은 단위면 1
+static int cloneNested(const CloneUnit *a, const CloneUnit *b) {
+    if (a->fn != b->fn) return 0;
+    return (a->pre <= b->pre && b->post <= a->post) || (b->pre <= a->pre && a->post <= b->post);
+}
+
+static int cloneSame(int a, int b) {
+    uint64_t ba[CLONE_K], bb[CLONE_K];
+    const uint64_t *x = cloneSketch(a, ba), *y = cloneSketch(b, bb);
+    int same = 0;
+    for (int k = 0; k < CLONE_K; k++) same += x[k] == y[k];
+    return same;
+}
+
+// 유니온 파인드. 루트는 항상 클래스에서 가장 작은 단위 번호
+static int ufFind(int *uf, int x) {
+    while (uf[x] != x) x = uf[x] = uf[uf[x]];
+    return x;
+}
+
+static void ufUnion(int *uf, int *same, int a, int b, int s) {
+    a = ufFind(uf, a);
+    b = ufFind(uf, b);
+    if (b < a) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    if (a != b) {
+        uf[b] = a;
+        if (same[b] < same[a]) same[a] = same[b];
+    }
+    if (s < same[a]) same[a] = s;
+}
+
+// 같은 키를 가진 단위 묶음을 bk에 모아 정렬
+static int cloneBuckets(CloneBucket *bk, const char *pick, int band) {
+    int rows = CLONE_K / CLONE_BANDS, n = 0;
+    uint64_t buf[CLONE_K];
+    for (int u = 0; u < cloneCnt; u++) {
+        if (!pick[u]) continue;
+        const uint64_t *mh = cloneSketch(u, buf);
+        uint64_t h = band + 1;
+        int from = band < 0 ? 0 : band * rows, to = band < 0 ? CLONE_K : from + rows;
+        for (int r = from; r < to; r++) h = hashMix(h, mh[r]);
+        bk[n++] = (CloneBucket){h, u};
+    }
+    qsort(bk, n, sizeof(CloneBucket), cmpBucket);
+    return n;
+}
+
+// 스케치가 똑같은 단위를 먼저 한 클래스로 묶고, 대표만 LSH 밴드에 넣는다.
+// 밴드 버킷 안에서 일치율이 기준 이상인 쌍을 같은 클래스로 합친다.
+// 버킷이 CLONE_BUCKET_MAX보다 크면 모든 쌍 대신 첫 단위와만 비교한다.
+// 모든 구성원의 바깥 단위가 한 클래스에 들어 있으면 그 클래스는 생략. 클래스 수 반환
+int findClones(CloneClass **out) {
+    int *uf = malloc((cloneCnt + 1) * sizeof(int));
+    int *same = malloc((cloneCnt + 1) * sizeof(int));
+    char *pick = calloc(cloneCnt + 1, 1);
+    for (int u = 0; u < cloneCnt; u++) {
+        uf[u] = u;
+        same[u] = CLONE_K;
+        pick[u] = cloneUnits[u].nshingles >= CLONE_MIN_SHINGLES;
+    }
+    CloneBucket *bk = malloc((cloneCnt + 1) * sizeof(CloneBucket));
+
+    // 1. 스케치 전체가 같은 단위
+    int nbk = cloneBuckets(bk, pick, -1);
+    for (int i = 0, j; i < nbk; i = j) {
+        for (j = i + 1; j < nbk && bk[j].key == bk[i].key; j++) {
+            int a = bk[i].unit, b = bk[j].unit;
+            if (cloneNested(&cloneUnits[a], &cloneUnits[b]) || cloneSame(a, b) != CLONE_K) continue;
+            ufUnion(uf, same, a, b, CLONE_K);
+            pick[b] = 0;
+        }
+    }
+
+    // 2. 대표끼리 밴드별 후보
+    for (int band = 0; band < CLONE_BANDS; band++) {
+        nbk = cloneBuckets(bk, pick, band);
+        for (int i = 0, j; i < nbk; i = j) {
+            for (j = i + 1; j < nbk && bk[j].key == bk[i].key; j++);
+            int star = j - i > CLONE_BUCKET_MAX;
+            for (int x = i; x < (star ? i + 1 : j); x++) {
+                for (int y = x + 1; y < j; y++) {
+                    int a = bk[x].unit, b = bk[y].unit;
+                    if (ufFind(uf, a) == ufFind(uf, b) || cloneNested(&cloneUnits[a], &cloneUnits[b])) continue;
+                    int s = cloneSame(a, b);
+                    if (s >= CLONE_THRESHOLD * CLONE_K) ufUnion(uf, same, a, b, s);
+                }
+            }
+        }
+    }
+    free(bk);
+    free(pick);
+
+    // 3. 루트별 구성원. 바깥 단위가 같은 클래스에 있으면 안쪽은 뺀다
+    int *size = calloc(cloneCnt + 1, sizeof(int));
+    char *inner = calloc(cloneCnt + 1, 1);
+    for (int u = 0; u < cloneCnt; u++) {
+        int r = ufFind(uf, u);
+        for (int p = cloneUnits[u].parent; p >= 0 && !inner[u]; p = cloneUnits[p].parent) {
+            inner[u] = ufFind(uf, p) == r;
+        }
+        if (!inner[u]) size[r]++;
+    }
+    CloneClass *cls = NULL;
+    int ncls = 0, clsCap = 0;
+    int *slot = malloc((cloneCnt + 1) * sizeof(int));
+    for (int u = 0; u < cloneCnt; u++) {
+        int r = uf[u]; // ufFind로 이미 압축됨
+        if (size[r] < 2 || inner[u]) continue;
+        if (r == u) {
+            slot[r] = ncls;
+            PUSH(cls, ncls, clsCap, ((CloneClass){malloc(size[r] * sizeof(int)), 0, same[r]}));
+        }
+        CloneClass *c = &cls[slot[r]];
+        c->units[c->n++] = u;
+    }
+
+    // 4. 바깥 단위들이 통째로 다른 한 클래스면 생략
+    int n = 0;
+    for (int i = 0; i < ncls; i++) {
+        CloneClass *c = &cls[i];
+        int outer = -1, redundant = 1;
+        for (int k = 0; k < c->n && redundant; k++) {
+            int p = cloneUnits[c->units[k]].parent;
+            int r = p >= 0 ? ufFind(uf, p) : -1;
+            if (r < 0 || size[r] < 2 || r == ufFind(uf, c->units[0]) || (outer >= 0 && r != outer)) redundant = 0;
+            outer = r;
+        }
+        if (redundant) free(c->units);
+        else cls[n++] = *c;
+    }
+
+    free(uf);
+    free(same);
+    free(size);
+    free(inner);
+    free(slot);
+    *out = cls;
+    return n;
+}
+
+void freeClones(CloneClass *cls, int n) {
+    for (int i = 0; i < n; i++) free(cls[i].units);
+    free(cls);
+}
+
+// ext 항목 하나 처리
+void visitExt(cJSON *node) {
+    if (funcCnt == funcCap) {
+        funcCap = funcCap ? funcCap * 2 : 64;
+        funcs = realloc(funcs, funcCap * sizeof(Func));
+    }
+    if (extFunc(node, &funcs[funcCnt])) {
+        funcCnt++;
+        return;
+    }
+
+    // 함수가 아닌 최상위 선언은 전역 변수, typedef는 이름만 기록
+    cJSON *name = OBJ(node, "name");
+    if (!strcmp(astType(node), "Typedef") && IS_STR(name)) {
+        typedefDefine(name->valuestring, resolveType(node));
+        return;
+    }
+    if (strcmp(astType(node), "Decl") || !IS_STR(name)) return;
+    cJSON *st;
+    cJSON_ArrayForEach(st, OBJ(node, "storage")) {
+        if (IS_STR(st) && !strcmp(st->valuestring, "typedef")) return;
+    }
+    addGlobal(name->valuestring, resolveType(OBJ(node, "type")));
+}
+
+void traverse(cJSON *root) {
+    cJSON *ext = OBJ(root, "ext");
+    if (!IS_ARR(ext)) return;
+
+    cJSON *node;
+    cJSON_ArrayForEach(node, ext) {
+        visitExt(node);
+    }
+}
+
+// ===== ext 항목 스캐너 =====
+// 바이트 스트림에서 최상위 "ext" 배열의 원소 경계를 찾는다.
+// 문자열/이스케이프 안의 괄호는 무시하고 깊이만 추적한다.
+// 원소가 한 버퍼 안에 있으면 그 버퍼를 그대로 넘기고, 버퍼 경계에
+// 걸친 원소만 elem에 모아서 넘긴다.
+typedef void (*ExtFn)(const char *json, size_t len, void *ctx);
 
 typedef struct {
-    char *type;
-    char *name;
-} Param;
+    int depth;
+    int inStr, esc;
+    int inExt;          // "ext" 배열 안
+    int inElem;         // 원소 수집 중
+    int seenRoot;       // 최상위 값이 열렸는지
+    char key[8];        // 깊이 1에서 마지막으로 본 문자열 (키 판별용)
+    int keyLen;
+    const char *elemStart;  // 현재 버퍼에서 원소(의 나머지)가 시작하는 위치
+    char *elem;             // 이전 버퍼들에 걸친 앞부분
+    size_t elemLen, elemCap;
+    ExtFn fn;
+    void *ctx;
+} ExtScanner;
+
+void scannerInit(ExtScanner *s, ExtFn fn, void *ctx) {
+    memset(s, 0, sizeof(ExtScanner));
+    s->fn = fn;
+    s->ctx = ctx;
+}
+
+void scannerFree(ExtScanner *s) {
+    free(s->elem);
+    s->elem = NULL;
+}
+
+static void elemAppend(ExtScanner *s, const char *p, size_t n) {
+    if (s->elemLen + n > s->elemCap) {
+        while (s->elemLen + n > s->elemCap) s->elemCap = s->elemCap ? s->elemCap * 2 : 4096;
+        s->elem = realloc(s->elem, s->elemCap);
+    }
+    memcpy(s->elem + s->elemLen, p, n);
+    s->elemLen += n;
+}
+
+// 실패(괄호 불일치) 시 0
+int scannerFeed(ExtScanner *s, const char *buf, size_t len) {
+    if (s->inElem) s->elemStart = buf;
+
+    for (size_t i = 0; i < len; i++) {
+        char c = buf[i];
+
+        if (s->inStr) {
+            if (s->esc) s->esc = 0;
+            else if (c == '\\') s->esc = 1;
+            else if (c == '"') s->inStr = 0;
+            else if (s->depth == 1 && s->keyLen < (int)sizeof(s->key) - 1) s->key[s->keyLen++] = c;
+            continue;
+        }
+
+        if (c == '"') {
+            s->inStr = 1;
+            if (s->depth == 1) s->keyLen = 0;
+        } else if (c == '{' || c == '[') {
+            if (s->inExt && s->depth == 2 && !s->inElem) {
+                s->inElem = 1;
+                s->elemStart = buf + i;
+                s->elemLen = 0;
+            } else if (c == '[' && s->depth == 1 && s->keyLen == 3 && !memcmp(s->key, "ext", 3)) {
+                s->inExt = 1;
+            }
+            if (s->depth++ == 0) s->seenRoot = 1;
+        } else if (c == '}' || c == ']') {
+            if (--s->depth < 0) return 0;
+            if (s->inElem && s->depth == 2) {
+                s->inElem = 0;
+                size_t n = buf + i + 1 - s->elemStart;
+                if (!s->elemLen) {
+                    s->fn(s->elemStart, n, s->ctx);
+                } else {
+                    elemAppend(s, s->elemStart, n);
+                    s->fn(s->elem, s->elemLen, s->ctx);
+                }
+            } else if (s->inExt && s->depth == 1) {
+                s->inExt = 0;
+            }
+        }
+    }
+
+    // 버퍼 경계에 걸친 원소는 다음 버퍼가 오기 전에 복사해 둔다
+    if (s->inElem) elemAppend(s, s->elemStart, buf + len - s->elemStart);
+    return 1;
+}
+
+// 입력이 끝났을 때 호출. 열린 괄호가 남아 있으면 0
+int scannerDone(ExtScanner *s) {
+    return s->seenRoot && s->depth == 0 && !s->inStr;
+}
+
+// ===== 파이프라인 리더 =====
+// 리더 스레드가 고정 크기 버퍼 두 개를 번갈아 채우고,
+// 메인 스레드는 채워진 버퍼를 스캔해 완성된 ext 원소부터 바로 분석한다.
+#define CHUNK_SIZE (1 << 16)
+
+typedef struct {
+    char data[CHUNK_SIZE];
+    size_t len;
+    int full;
+} Chunk;
+
+typedef struct {
+    FILE *fp;
+    Chunk bufs[2];
+    int stop;   // 소비자가 중단을 요청
+    pthread_mutex_t mu;
+    pthread_cond_t cv;
+} Reader;
+
+static void *readerMain(void *arg) {
+    Reader *r = arg;
+    for (int i = 0;; i ^= 1) {
+        Chunk *c = &r->bufs[i];
+        pthread_mutex_lock(&r->mu);
+        while (c->full && !r->stop) pthread_cond_wait(&r->cv, &r->mu);
+        int stop = r->stop;
+        pthread_mutex_unlock(&r->mu);
+        if (stop) return NULL;
+
+        // 버퍼가 비어 있는 동안은 리더만 접근한다
+        size_t n = fread(c->data, 1, CHUNK_SIZE, r->fp);
+
+        pthread_mutex_lock(&r->mu);
+        c->len = n;
+        c->full = 1;
+        pthread_cond_broadcast(&r->cv);
+        pthread_mutex_unlock(&r->mu);
+
+        // 짧게 읽혔으면 EOF 또는 오류
+        if (n < CHUNK_SIZE) return NULL;
+    }
+}
+
+typedef struct {
+    NodeFn fn;
+    void *ctx;
+    int failed;
+} StreamCtx;
+
+static void onExt(const char *json, size_t len, void *ctx) {
+    StreamCtx *sc = ctx;
+    if (sc->failed) return;
+
+    cJSON *node = cJSON_ParseWithLength(json, len);
+    if (!node) {
+        sc->failed = 1;
+        return;
+    }
+    if (!sc->fn(node, sc->ctx)) cJSON_Delete(node);
+}
+
+// 파일을 읽으면서 ext 원소 단위로 파싱해 fn에 넘긴다. 실패 시 0
+int streamExt(FILE *fp, NodeFn fn, void *ctx) {
+    Reader *r = calloc(1, sizeof(Reader));
+    r->fp = fp;
+    pthread_mutex_init(&r->mu, NULL);
+    pthread_cond_init(&r->cv, NULL);
+
+    pthread_t th;
+    if (pthread_create(&th, NULL, readerMain, r) != 0) {
+        free(r);
+        return 0;
+    }
+
+    StreamCtx sc = {fn, ctx, 0};
+    ExtScanner s;
+    scannerInit(&s, onExt, &sc);
+
+    int ok = 1;
+    for (int i = 0;; i ^= 1) {
+        Chunk *c = &r->bufs[i];
+        pthread_mutex_lock(&r->mu);
+        while (!c->full) pthread_cond_wait(&r->cv, &r->mu);
+        pthread_mutex_unlock(&r->mu);
+
+        int last = c->len < CHUNK_SIZE;
+        ok = scannerFeed(&s, c->data, c->len) && !sc.failed;
+
+        pthread_mutex_lock(&r->mu);
+        c->full = 0;
+        if (!ok) r->stop = 1;
+        pthread_cond_broadcast(&r->cv);
+        pthread_mutex_unlock(&r->mu);
+
+        if (!ok || last) break;
+    }
+    pthread_join(th, NULL);
+
+    if (ok) ok = !ferror(fp) && scannerDone(&s);
+
+    scannerFree(&s);
+    pthread_mutex_destroy(&r->mu);
+    pthread_cond_destroy(&r->cv);
+    free(r);
+    return ok;
+}
+
+static int analyzeNode(cJSON *node, void *ctx) {
+    (void)ctx;
+    visitExt(node);
+    return 0;
+}
+
+// ===== 병렬 로더 =====
+// 1단계: 파일을 mmap하고 순차 스캔으로 ext 원소의 바이트 범위만 찾는다.
+// 2단계: 범위들을 여러 스레드가 나눠 파싱한다. 노드는 스레드별 아레나에
+// 할당되고, 결과를 순서대로 이어 붙여 FileAST 하나로 만든다.
+#define ARENA_BLOCK (1 << 20)
+
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t used, cap;
+    max_align_t data[];
+} ArenaBlock;
+
+typedef struct {
+    ArenaBlock *head;
+} Arena;
+
+static void *arenaAlloc(Arena *a, size_t n) {
+    n = (n + sizeof(max_align_t) - 1) & ~(sizeof(max_align_t) - 1);
+    ArenaBlock *b = a->head;
+    if (!b || b->used + n > b->cap) {
+        size_t cap = n > ARENA_BLOCK ? n : ARENA_BLOCK;
+        b = malloc(sizeof(ArenaBlock) + cap);
+        if (!b) return NULL;
+        b->next = a->head;
+        b->used = 0;
+        b->cap = cap;
+        a->head = b;
+    }
+    void *p = (char *)b->data + b->used;
+    b->used += n;
+    return p;
+}
+
+static void arenaFree(Arena *a) {
+    while (a->head) {
+        ArenaBlock *next = a->head->next;
+        free(a->head);
+        a->head = next;
+    }
+}
+
+// cJSON 할당 훅: 아레나가 지정된 스레드에서는 아레나에서 할당하고 해제는 무시한다.
+// 아레나에 올라간 트리는 cJSON_Delete 대신 아레나째로 해제해야 한다.
+static __thread Arena *curArena;
+
+static void *hookMalloc(size_t n) {
+    return curArena ? arenaAlloc(curArena, n) : malloc(n);
+}
+
+static void hookFree(void *p) {
+    if (!curArena) free(p);
+}
+
+typedef struct {
+    size_t off, len;
+} ExtRange;
+
+typedef struct {
+    const char *base;
+    ExtRange *ranges;
+    int cnt, cap;
+} RangeList;
+
+static void onRange(const char *json, size_t len, void *ctx) {
+    RangeList *r = ctx;
+    if (r->cnt == r->cap) {
+        r->cap = r->cap ? r->cap * 2 : 256;
+        r->ranges = realloc(r->ranges, r->cap * sizeof(ExtRange));
+    }
+    r->ranges[r->cnt].off = json - r->base;
+    r->ranges[r->cnt].len = len;
+    r->cnt++;
+}
+
+typedef struct {
+    const char *base;
+    RangeList *list;
+    cJSON **nodes;
+    int next;       // 다음에 가져갈 범위 (원자적으로 증가)
+    int failed;
+} ParseJob;
+
+typedef struct {
+    ParseJob *job;
+    Arena arena;
+} ParseWorker;
+
+static void *parseWorker(void *arg) {
+    ParseWorker *w = arg;
+    ParseJob *job = w->job;
+    curArena = &w->arena;
+    for (;;) {
+        int i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+        if (i >= job->list->cnt || __atomic_load_n(&job->failed, __ATOMIC_RELAXED)) break;
+        ExtRange *r = &job->list->ranges[i];
+        job->nodes[i] = cJSON_ParseWithLength(job->base + r->off, r->len);
+        if (!job->nodes[i]) __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+    }
+    curArena = NULL;
+    return NULL;
+}
+
+typedef struct {
+    cJSON *root;
+    Arena *arenas;      // 스레드별 + 이어 붙이기용 1개
+    int narenas;
+} ParLoad;
+
+void parFree(ParLoad *pl) {
+    for (int i = 0; i < pl->narenas; i++) arenaFree(&pl->arenas[i]);
+    free(pl->arenas);
+    memset(pl, 0, sizeof(ParLoad));
+}
+
+// path를 threads개 스레드로 파싱. 실패 시 0
+int parLoad(const char *path, int threads, ParLoad *pl) {
+    memset(pl, 0, sizeof(ParLoad));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror("파일 열기 실패");
+        return 0;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    const char *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return 0;
+    madvise((void *)data, st.st_size, MADV_SEQUENTIAL);
+
+    // 1단계: 원소 범위
+    RangeList list = {data, NULL, 0, 0};
+    ExtScanner s;
+    scannerInit(&s, onRange, &list);
+    int ok = scannerFeed(&s, data, st.st_size) && scannerDone(&s);
+    scannerFree(&s);
+
+    // 2단계: 병렬 파싱
+    if (ok) {
+        static cJSON_Hooks hooks = {hookMalloc, hookFree};
+        cJSON_InitHooks(&hooks);
+
+        if (threads > list.cnt) threads = list.cnt > 0 ? list.cnt : 1;
+        ParseJob job = {data, &list, calloc(list.cnt + 1, sizeof(cJSON *)), 0, 0};
+        ParseWorker *ws = calloc(threads, sizeof(ParseWorker));
+        pthread_t *th = malloc(threads * sizeof(pthread_t));
+        int started = 0;
+        for (; started < threads; started++) {
+            ws[started].job = &job;
+            if (pthread_create(&th[started], NULL, parseWorker, &ws[started]) != 0) break;
+        }
+        if (!started) parseWorker(&ws[0]); // 스레드를 못 만들면 직접
+        for (int i = 0; i < started; i++) pthread_join(th[i], NULL);
+        ok = !job.failed;
+
+        // 아레나 소유권을 결과로 옮기고, 루트와 ext 배열도 별도 아레나에 만든다
+        pl->narenas = threads + 1;
+        pl->arenas = calloc(pl->narenas, sizeof(Arena));
+        for (int i = 0; i < threads; i++) pl->arenas[i] = ws[i].arena;
+
+        if (ok) {
+            curArena = &pl->arenas[threads];
+            cJSON *root = cJSON_CreateObject();
+            cJSON *ext = cJSON_CreateArray();
+            cJSON_AddItemToObject(root, "_nodetype", cJSON_CreateString("FileAST"));
+            cJSON_AddItemToObject(root, "ext", ext);
+            curArena = NULL;
+
+            // 원소는 원래 순서대로 직접 이어 붙인다
+            cJSON *prev = NULL;
+            for (int i = 0; i < list.cnt; i++) {
+                cJSON *n = job.nodes[i];
+                n->prev = prev;
+                if (prev) prev->next = n;
+                else ext->child = n;
+                prev = n;
+            }
+            if (ext->child) ext->child->prev = prev;
+            pl->root = root;
+        }
+
+        free(job.nodes);
+        free(ws);
+        free(th);
+    }
+
+    free(list.ranges);
+    munmap((void *)data, st.st_size);
+    if (!ok) parFree(pl);
+    return ok;
+}
+
+// ===== 프로젝트 심볼 링크 =====
+// 여러 TU를 작업 스레드가 나눠 읽으며 함수 선언/정의를 샤드별 락을 가진
+// 해시 테이블에 넣는다. 같은 이름의 프로토타입은 시그니처별로 합치고,
+// 다 읽은 뒤 정의와 맞춰 충돌/중복 정의/외부 심볼/정의 없는 static을 보고한다.
+// 타입 테이블은 스레드 안전하지 않아 시그니처를 구할 때만 typeLock을 잡는다.
+#define SYM_SHARDS 64
+
+typedef struct {
+    int sig, ret;
+    int noproto;        // f() 선언: 반환 타입만 맞으면 호환
+    int decls, defs;
+    int firstTu;        // 가장 앞선 TU (스레드 순서와 무관하게 출력이 같도록)
+} SymVariant;
 
 typedef struct {
     char *name;
-    char *retType;
-    int ifs;
-    int argc;
-    Param args[10]; // 최대 10개
-} Func;
+    int isStatic;       // 내부 링크 (키가 "이름@TU번호")
+    int tu;             // static일 때 속한 TU
+    SymVariant *vars;   // 서로 다른 시그니처
+    int nvars, varCap;
+    int *defTus;
+    int ndefs, defCap;
+} Symbol;
+
+typedef struct {
+    pthread_mutex_t lock;
+    StrMap ids;         // 키 -> syms 인덱스 (static 함수는 "이름@TU번호")
+    Symbol *syms;
+    int cnt, cap;
+} SymShard;
+
+static SymShard symShards[SYM_SHARDS];
+static pthread_mutex_t typeLock = PTHREAD_MUTEX_INITIALIZER;
 
-#define MAX_FUNCS 100
-Func funcs[MAX_FUNCS];
-int funcCnt = 0;
+static void symAdd(const char *key, const char *name, const SymVariant *v, int isDef, int isStatic, int tu) {
+    // 샤드는 상위 비트로 (StrMap 슬롯은 하위 비트를 쓴다)
+    SymShard *sh = &symShards[hashStr(key) >> 58 & (SYM_SHARDS - 1)];
+    pthread_mutex_lock(&sh->lock);
 
-const char *getType(cJSON *node) {
-    if (!node) return "unknown";
-    cJSON *names = OBJ(node, "names");
-    if (IS_ARR(names) && ARR_SIZE(names) > 0) {
-        cJSON *n = ARR(names, 0);
-        if (IS_STR(n)) return n->valuestring;
+    int id = mapGet(&sh->ids, key);
+    if (id < 0) {
+        if (sh->cnt == sh->cap) {
+            sh->cap = sh->cap ? sh->cap * 2 : 64;
+            sh->syms = realloc(sh->syms, sh->cap * sizeof(Symbol));
+        }
+        id = sh->cnt++;
+        memset(&sh->syms[id], 0, sizeof(Symbol));
+        sh->syms[id].name = strdup(name);
+        sh->syms[id].isStatic = isStatic;
+        sh->syms[id].tu = tu;
+        mapPut(&sh->ids, key, id);
+    }
+    Symbol *s = &sh->syms[id];
+
+    SymVariant *m = NULL;
+    for (int i = 0; i < s->nvars && !m; i++) {
+        if (s->vars[i].sig == v->sig) m = &s->vars[i];
+    }
+    if (!m) {
+        SymVariant nv = *v;
+        nv.firstTu = tu;
+        PUSH(s->vars, s->nvars, s->varCap, nv);
+        m = &s->vars[s->nvars - 1];
     }
-    return "unknown";
+    if (tu < m->firstTu) m->firstTu = tu;
+    if (isDef) {
+        m->defs++;
+        PUSH(s->defTus, s->ndefs, s->defCap, tu);
+    } else {
+        m->decls++;
+    }
+    pthread_mutex_unlock(&sh->lock);
 }
 
-void parseFunc(cJSON *decl) {
-    if (!decl) return;
+typedef struct {
+    int tu;
+    StrMap statics;     // 이 TU에서 static으로 선언된 함수 이름
+} LinkCtx;
 
-    Func *f = &funcs[funcCnt];
-    memset(f, 0, sizeof(Func));
+// 링크 비교용 시그니처: 반환 타입의 최상위 한정자는 호환성에 영향이 없다
+// (파라미터는 resolveType에서 이미 조정됨)
+static int linkSig(int id) {
+    if (types[id].kind != TY_FUNC || !types[types[id].base].quals) return id;
+    Type t = types[id];
+    t.base = paramAdjust(t.base);
+    return typeIntern(&t);
+}
+
+// 함수 선언/정의만 심볼 테이블로. 노드는 보관하지 않는다
+static int onLinkExt(cJSON *node, void *ctx) {
+    LinkCtx *c = ctx;
+    int tu = c->tu;
+    cJSON *decl = node;
+    if (!strcmp(astType(node), "Typedef")) {
+        // 시그니처에 쓰인 typedef 이름을 풀 수 있게 TU별로 등록
+        cJSON *name = OBJ(node, "name");
+        if (!IS_STR(name)) return 0;
+        pthread_mutex_lock(&typeLock);
+        typedefTu = tu;
+        typedefDefine(name->valuestring, resolveType(node));
+        pthread_mutex_unlock(&typeLock);
+        return 0;
+    }
+    int isDef = !strcmp(astType(node), "FuncDef");
+    if (isDef) decl = OBJ(node, "decl");
+    else if (strcmp(astType(node), "Decl") || strcmp(astType(OBJ(node, "type")), "FuncDecl")) return 0;
 
     cJSON *name = OBJ(decl, "name");
-    f->name = name ? strdup(name->valuestring) : strdup("unknown");
+    if (!IS_STR(name)) return 0;
+    int isStatic = 0;
+    cJSON *st;
+    cJSON_ArrayForEach(st, OBJ(decl, "storage")) {
+        isStatic |= IS_STR(st) && !strcmp(st->valuestring, "static");
+    }
+    // 앞서 static으로 선언됐으면 static 없는 선언/정의도 내부 링크
+    if (isStatic) mapPut(&c->statics, name->valuestring, 1);
+    else isStatic = mapGet(&c->statics, name->valuestring) >= 0;
 
-    cJSON *type = OBJ(decl, "type");
-    cJSON *ret = OBJ(type, "type");
-    cJSON *idType = ret ? OBJ(ret, "type") : NULL;
-    f->retType = idType ? strdup(getType(idType)) : strdup("unknown");
+    SymVariant v = {0};
+    pthread_mutex_lock(&typeLock);
+    typedefTu = tu;
+    v.sig = linkSig(resolveType(OBJ(decl, "type")));
+    v.ret = types[v.sig].base;
+    v.noproto = (types[v.sig].flags & F_NOPROTO) != 0;
+    pthread_mutex_unlock(&typeLock);
 
-    cJSON *params = OBJ(OBJ(type, "args"), "params");
-    if (IS_ARR(params)) {
-        int n = ARR_SIZE(params);
-        for (int i = 0; i < n && i < 10; i++) {
-            cJSON *p = ARR(params, i);
-            cJSON *pt = OBJ(p, "type");
-            cJSON *td = pt ? OBJ(pt, "type") : NULL;
-            if (!td) continue;
+    char key[512];
+    snprintf(key, sizeof(key), isStatic ? "%s@%d" : "%s", name->valuestring, tu);
+    symAdd(key, name->valuestring, &v, isDef, isStatic, tu);
+    return 0;
+}
+
+typedef struct {
+    char **paths;
+    int cnt;
+    int next;       // 다음에 가져갈 TU (원자적으로 증가)
+    int failed;
+} LinkJob;
+
+static void *linkWorker(void *arg) {
+    LinkJob *job = arg;
+    for (;;) {
+        int i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+        if (i >= job->cnt) break;
+        LinkCtx c = {i, {0}};
+        if (!loadExt(job->paths[i], onLinkExt, &c)) __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        mapFree(&c.statics);
+    }
+    return NULL;
+}
+
+// 이름 순, 같은 이름의 static은 외부 심볼 뒤에 TU 순서로 (샤드 삽입 순서와 무관하게)
+static int cmpSymName(const void *a, const void *b) {
+    const Symbol *x = *(Symbol *const *)a, *y = *(Symbol *const *)b;
+    int c = strcmp(x->name, y->name);
+    if (c) return c;
+    if (x->isStatic != y->isStatic) return x->isStatic - y->isStatic;
+    return x->isStatic ? x->tu - y->tu : 0;
+}
+
+static int cmpInt(const void *a, const void *b) {
+    return *(const int *)a - *(const int *)b;
+}
+
+static int sigCompat(const SymVariant *a, const SymVariant *b) {
+    return a->sig == b->sig || ((a->noproto || b->noproto) && a->ret == b->ret);
+}
+
+// 대표 시그니처: 정의가 있으면 정의, 없으면 프로토타입 있는 선언, 같은 조건이면 앞선 TU
+static const SymVariant *symRep(const Symbol *s) {
+    const SymVariant *r = &s->vars[0];
+    for (int i = 1; i < s->nvars; i++) {
+        const SymVariant *v = &s->vars[i];
+        int better = (v->defs > 0) - (r->defs > 0);
+        if (!better) better = (!v->noproto) - (!r->noproto);
+        if (better > 0 || (!better && v->firstTu < r->firstTu)) r = v;
+    }
+    return r;
+}
+
+// paths의 TU들을 threads개 스레드로 읽어 링크 결과를 출력한다
+int linkProject(char **paths, int cnt, int threads) {
+    for (int i = 0; i < SYM_SHARDS; i++) pthread_mutex_init(&symShards[i].lock, NULL);
+
+    LinkJob job = {paths, cnt, 0, 0};
+    if (threads > cnt) threads = cnt > 0 ? cnt : 1;
+    pthread_t *th = malloc(threads * sizeof(pthread_t));
+    int started = 0;
+    for (; started < threads; started++) {
+        if (pthread_create(&th[started], NULL, linkWorker, &job) != 0) break;
+    }
+    if (!started) linkWorker(&job);
+    for (int i = 0; i < started; i++) pthread_join(th[i], NULL);
+    free(th);
+
+    // 이름 순으로 모아서 보고
+    int total = 0;
+    for (int i = 0; i < SYM_SHARDS; i++) total += symShards[i].cnt;
+    Symbol **all = malloc((total + 1) * sizeof(Symbol *));
+    int n = 0;
+    for (int i = 0; i < SYM_SHARDS; i++) {
+        for (int j = 0; j < symShards[i].cnt; j++) all[n++] = &symShards[i].syms[j];
+    }
+    qsort(all, n, sizeof(Symbol *), cmpSymName);
 
-            const char *t = getType(td);
-            const char *n = "arg";
-            cJSON *pn = OBJ(pt, "declname");
-            if (pn && IS_STR(pn)) n = pn->valuestring;
+    int defined = 0, conflicts = 0, dups = 0;
+    printf("==== 심볼 링크 결과 ====\n");
+    for (int i = 0; i < n; i++) {
+        Symbol *s = all[i];
+        const SymVariant *r = symRep(s);
+        if (s->ndefs) defined++;
 
-            f->args[f->argc].type = strdup(t);
-            f->args[f->argc].name = strdup(n);
-            f->argc++;
+        int bad = 0;
+        for (int j = 0; j < s->nvars; j++) bad |= !sigCompat(r, &s->vars[j]);
+        if (bad) {
+            conflicts++;
+            printf("\n[충돌] %s\n", s->name);
+            printf("  - %s : %s (%s)\n", typeStr(r->sig), paths[r->firstTu], r->defs ? "정의" : "선언");
+            for (int j = 0; j < s->nvars; j++) {
+                const SymVariant *v = &s->vars[j];
+                if (sigCompat(r, v)) continue;
+                printf("  - %s : %s (%s)\n", typeStr(v->sig), paths[v->firstTu], v->defs ? "정의" : "선언");
+            }
         }
+        if (s->ndefs > 1) {
+            dups++;
+            qsort(s->defTus, s->ndefs, sizeof(int), cmpInt);
+            printf("\n[중복 정의] %s:", s->name);
+            for (int j = 0; j < s->ndefs; j++) printf("%s %s", j ? "," : "", paths[s->defTus[j]]);
+            printf("\n");
+        }
+    }
+
+    // static은 다른 TU에서 정의될 수 없으므로 외부 심볼과 따로 보고
+    int undefStatic = 0;
+    for (int i = 0; i < n; i++) {
+        if (all[i]->ndefs || !all[i]->isStatic) continue;
+        if (!undefStatic++) printf("\n[정의 없는 static]\n");
+        printf("  - %s : %s\n", all[i]->name, paths[all[i]->tu]);
+    }
+
+    printf("\n외부 심볼:");
+    int ext = 0;
+    for (int i = 0; i < n; i++) {
+        if (!all[i]->ndefs && !all[i]->isStatic) printf("%s %s", ext++ ? "," : "", all[i]->name);
     }
+    printf("%s\n", ext ? "" : " 없음");
+    printf("TU %d개, 심볼 %d개 (정의 %d개, 외부 %d개), 충돌 %d개, 중복 정의 %d개, 정의 없는 static %d개\n", cnt,
+           n, defined, ext, conflicts, dups, undefStatic);
+
+    free(all);
+    return job.failed || conflicts || dups;
+}
+
+// ===== AST 비교 (diff 모드) =====
+// 모든 노드에 coord를 제외한 머클 해시를 한 번에 계산해 두고,
+// 해시가 다른 서브트리로만 내려가며 변경 위치를 찾는다.
+typedef struct HNode {
+    uint64_t h;
+    cJSON *json;
+    struct HNode *kids;     // json 자식과 같은 순서
+    int nkids;
+} HNode;
 
-    funcCnt++;
+static int isCoord(cJSON *n) {
+    return n->string && !strcmp(n->string, "coord");
 }
 
-void countIf(cJSON *node, Func *f) {
-    if (!node || !f) return;
+static void hashBuild(HNode *hn, cJSON *n) {
+    hn->json = n;
+    hn->nkids = ARR_SIZE(n);
+    hn->kids = hn->nkids ? calloc(hn->nkids, sizeof(HNode)) : NULL;
 
-    cJSON *type = OBJ(node, "_nodetype");
-    if (type && !strcmp(type->valuestring, "If")) f->ifs++;
+    uint64_t h = hashMix(0, (uint64_t)(n->type & 0xff));
+    if (IS_STR(n)) {
+        h = hashMix(h, hashStr(n->valuestring));
+    } else if (cJSON_IsNumber(n)) {
+        uint64_t bits;
+        memcpy(&bits, &n->valuedouble, sizeof(bits));
+        h = hashMix(h, bits);
+    }
 
-    cJSON *child;
-    cJSON_ArrayForEach(child, node) {
-        countIf(child, f);
+    int i = 0;
+    cJSON *c;
+    cJSON_ArrayForEach(c, n) {
+        HNode *k = &hn->kids[i++];
+        hashBuild(k, c);
+        if (isCoord(c)) continue;
+        if (c->string) h = hashMix(h, hashStr(c->string));
+        h = hashMix(h, k->h);
     }
+    hn->h = h;
 }
 
-void traverse(cJSON *root) {
-    cJSON *ext = OBJ(root, "ext");
-    if (!IS_ARR(ext)) return;
+static void hashFree(HNode *hn) {
+    for (int i = 0; i < hn->nkids; i++) hashFree(&hn->kids[i]);
+    free(hn->kids);
+}
 
-    cJSON *node;
-    cJSON_ArrayForEach(node, ext) {
-        cJSON *nt = OBJ(node, "_nodetype");
-        if (!nt || !IS_STR(nt)) continue;
-
-        if (!strcmp(nt->valuestring, "Decl")) {
-            cJSON *t = OBJ(node, "type");
-            cJSON *inner = t ? OBJ(t, "_nodetype") : NULL;
-            if (inner && !strcmp(inner->valuestring, "FuncDecl")) {
-                parseFunc(node);
-                funcs[funcCnt - 1].ifs = 0;
+static const char *nodeType(cJSON *n) {
+    cJSON *t = cJSON_IsObject(n) ? OBJ(n, "_nodetype") : NULL;
+    if (t && IS_STR(t)) return t->valuestring;
+    if (!n || cJSON_IsNull(n)) return "null";
+    if (IS_ARR(n)) return "[]";
+    return "값";
+}
+
+#define DIFF_SHOW 10    // 함수당 출력할 변경 위치 수
+
+typedef struct {
+    int edits;
+} DiffOut;
+
+// 값 노드는 값 그대로, 나머지는 노드 타입으로 출력
+static void printNode(cJSON *n) {
+    if (IS_STR(n)) printf("\"%s\"", n->valuestring);
+    else if (cJSON_IsNumber(n)) printf("%g", n->valuedouble);
+    else printf("%s", nodeType(n));
+}
+
+static void diffEdit(DiffOut *o, const char *path, const char *what, cJSON *a, cJSON *b) {
+    if (o->edits++ >= DIFF_SHOW) return;
+    printf("    - %s %s (", path[0] ? path : "(전체)", what);
+    if (a) printNode(a);
+    if (a && b) printf(" -> ");
+    if (b) printNode(b);
+    printf(")\n");
+}
+
+static void diffNode(HNode *a, HNode *b, char *path, size_t plen, DiffOut *o);
+
+// path 뒤에 세그먼트를 붙이고 a/b 비교 후 되돌린다
+static void diffChild(HNode *a, HNode *b, char *path, size_t plen, const char *key, int idx, DiffOut *o) {
+    size_t n;
+    if (key) n = snprintf(path + plen, 512 - plen, "%s%s", plen ? "." : "", key);
+    else n = snprintf(path + plen, 512 - plen, "[%d]", idx);
+    size_t len = plen + n < 511 ? plen + n : 511;
+
+    if (!a) diffEdit(o, path, "추가", NULL, b->json);
+    else if (!b) diffEdit(o, path, "삭제", a->json, NULL);
+    else diffNode(a, b, path, len, o);
+    path[plen] = '\0';
+}
+
+static void diffNode(HNode *a, HNode *b, char *path, size_t plen, DiffOut *o) {
+    if (a->h == b->h) return;
+
+    cJSON *ja = a->json, *jb = b->json;
+    if (cJSON_IsObject(ja) && cJSON_IsObject(jb) && !strcmp(nodeType(ja), nodeType(jb))) {
+        // 키로 맞춘다 (노드당 키 수가 작아 선형 탐색)
+        for (int i = 0; i < a->nkids; i++) {
+            cJSON *k = a->kids[i].json;
+            if (isCoord(k)) continue;
+            HNode *m = NULL;
+            for (int j = 0; j < b->nkids && !m; j++) {
+                if (!strcmp(b->kids[j].json->string, k->string)) m = &b->kids[j];
             }
-        } else if (!strcmp(nt->valuestring, "FuncDef")) {
-            cJSON *decl = OBJ(node, "decl");
-            cJSON *body = OBJ(node, "body");
-            parseFunc(decl);
-            countIf(body, &funcs[funcCnt - 1]);
+            diffChild(&a->kids[i], m, path, plen, k->string, 0, o);
+        }
+        for (int j = 0; j < b->nkids; j++) {
+            cJSON *k = b->kids[j].json;
+            if (isCoord(k) || OBJ(ja, k->string)) continue;
+            diffChild(NULL, &b->kids[j], path, plen, k->string, 0, o);
+        }
+        return;
+    }
+
+    if (IS_ARR(ja) && IS_ARR(jb)) {
+        // 같은 앞/뒤 부분은 건너뛰고 가운데만 인덱스로 맞춘다
+        int na = a->nkids, nb = b->nkids, pre = 0, suf = 0;
+        while (pre < na && pre < nb && a->kids[pre].h == b->kids[pre].h) pre++;
+        while (suf < na - pre && suf < nb - pre && a->kids[na - 1 - suf].h == b->kids[nb - 1 - suf].h) suf++;
+        for (int i = pre; i < na - suf || i < nb - suf; i++) {
+            HNode *x = i < na - suf ? &a->kids[i] : NULL;
+            HNode *y = i < nb - suf ? &b->kids[i] : NULL;
+            diffChild(x, y, path, plen, NULL, i, o);
         }
+        return;
     }
+
+    diffEdit(o, path, "변경", ja, jb);
 }
 
-int main() {
-    FILE *fp = fopen("ast.json", "r");
-    if (!fp) {
-        perror("파일 열기 실패");
+typedef struct {
+    char *key;          // "노드타입:이름#순번"
+    const char *name;
+    cJSON *node;
+    HNode h;
+    int isFunc;
+    Func f;
+} DiffEnt;
+
+typedef struct {
+    DiffEnt *ents;
+    int cnt, cap;
+    StrMap seen;        // 같은 이름의 순번
+} DiffSide;
+
+static const char *extName(cJSON *node) {
+    cJSON *nt = OBJ(node, "_nodetype");
+    cJSON *name = OBJ(node, "name");
+    if (nt && IS_STR(nt) && !strcmp(nt->valuestring, "FuncDef")) name = OBJ(OBJ(node, "decl"), "name");
+    return name && IS_STR(name) ? name->valuestring : "(이름 없음)";
+}
+
+static int collectNode(cJSON *node, void *ctx) {
+    DiffSide *d = ctx;
+    if (d->cnt == d->cap) {
+        d->cap = d->cap ? d->cap * 2 : 64;
+        d->ents = realloc(d->ents, d->cap * sizeof(DiffEnt));
+    }
+    DiffEnt *e = &d->ents[d->cnt++];
+    memset(e, 0, sizeof(DiffEnt));
+    e->node = node;
+    e->name = extName(node);
+    e->isFunc = extFunc(node, &e->f);
+    hashBuild(&e->h, node);
+
+    char key[512];
+    snprintf(key, sizeof(key), "%s:%s", nodeType(node), e->name);
+    int ord = mapGet(&d->seen, key) + 1;
+    mapPut(&d->seen, key, ord);
+    snprintf(key + strlen(key), sizeof(key) - strlen(key), "#%d", ord);
+    e->key = strdup(key);
+    return 1;
+}
+
+static int loadSide(const char *path, DiffSide *d) {
+    return loadExt(path, collectNode, d);
+}
+
+static void freeSide(DiffSide *d) {
+    for (int i = 0; i < d->cnt; i++) {
+        free(d->ents[i].key);
+        if (d->ents[i].isFunc) freeFunc(&d->ents[i].f);
+        hashFree(&d->ents[i].h);
+        cJSON_Delete(d->ents[i].node);
+    }
+    free(d->ents);
+    mapFree(&d->seen);
+}
+
+// 함수 지표 변화 출력
+static void diffMetrics(Func *a, Func *b) {
+    if (a->retType != b->retType) printf("  - 반환 타입: %s -> %s\n", typeStr(a->retType), typeStr(b->retType));
+    if (a->argc != b->argc) printf("  - 파라미터 개수: %d -> %d\n", a->argc, b->argc);
+    for (int i = 0; i < a->argc && i < b->argc; i++) {
+        if (a->args[i].type != b->args[i].type || strcmp(a->args[i].name, b->args[i].name)) {
+            char x[512], y[512];
+            typeDecl(a->args[i].type, a->args[i].name, x, sizeof(x));
+            typeDecl(b->args[i].type, b->args[i].name, y, sizeof(y));
+            printf("  - 파라미터 %d: %s -> %s\n", i + 1, x, y);
+        }
+    }
+    if (a->ifs != b->ifs) printf("  - if문 개수: %d -> %d\n", a->ifs, b->ifs);
+}
+
+int runDiff(const char *oldPath, const char *newPath) {
+    DiffSide a = {0}, b = {0};
+    if (!loadSide(oldPath, &a) || !loadSide(newPath, &b)) {
+        freeSide(&a);
+        freeSide(&b);
         return 1;
     }
 
-    fseek(fp, 0, SEEK_END);
-    long sz = ftell(fp);
-    rewind(fp);
+    StrMap idx = {0};
+    for (int i = 0; i < b.cnt; i++) mapPut(&idx, b.ents[i].key, i);
+    char *matched = calloc(b.cnt + 1, 1);
+
+    printf("==== AST 비교 결과 ====\n");
+    int same = 0, changed = 0;
+    char path[512];
+    for (int i = 0; i < a.cnt; i++) {
+        DiffEnt *x = &a.ents[i];
+        int j = mapGet(&idx, x->key);
+        if (j < 0) {
+            printf("\n[삭제] %s (%s)\n", x->name, nodeType(x->node));
+            changed++;
+            continue;
+        }
+        matched[j] = 1;
+        DiffEnt *y = &b.ents[j];
+        if (x->h.h == y->h.h) {
+            same++;
+            continue;
+        }
+
+        changed++;
+        printf("\n[수정] %s (%s)\n", x->name, nodeType(x->node));
+        if (x->isFunc && y->isFunc) diffMetrics(&x->f, &y->f);
+
+        DiffOut o = {0};
+        printf("  - 변경 위치:\n");
+        path[0] = '\0';
+        diffNode(&x->h, &y->h, path, 0, &o);
+        if (o.edits > DIFF_SHOW) printf("    - ... 외 %d곳\n", o.edits - DIFF_SHOW);
+    }
+    for (int j = 0; j < b.cnt; j++) {
+        if (matched[j]) continue;
+        printf("\n[추가] %s (%s)\n", b.ents[j].name, nodeType(b.ents[j].node));
+        changed++;
+    }
+    printf("\n변경 %d개, 동일 %d개\n", changed, same);
+
+    free(matched);
+    mapFree(&idx);
+    freeSide(&a);
+    freeSide(&b);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && !strcmp(argv[1], "-d")) {
+        if (argc != 4) {
+            fprintf(stderr, "사용법: %s -d <이전.json|.c> <이후.json|.c>\n", argv[0]);
+            return 1;
+        }
+        registerPass(&ifPass);
+        return runDiff(argv[2], argv[3]);
+    }
+    if (argc > 1 && !strcmp(argv[1], "-l")) {
+        // -l [-j N] <TU>...: 여러 TU의 함수 심볼을 병렬로 링크
+        int argi = 2, threads = 1;
+        if (argi + 1 < argc && !strcmp(argv[argi], "-j")) {
+            threads = atoi(argv[argi + 1]);
+            if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+            if (threads <= 0) threads = 1;
+            argi += 2;
+        }
+        if (argi >= argc) {
+            fprintf(stderr, "사용법: %s -l [-j N] <TU.json|.c>...\n", argv[0]);
+            return 1;
+        }
+        return linkProject(argv + argi, argc - argi, threads);
+    }
+    if (argc > 1 && !strcmp(argv[1], "-q")) {
+        // -q <저장소> [N] [열]: 저장된 결과에서 열 값 상위 N개
+        if (argc < 3 || argc > 5) {
+            fprintf(stderr, "사용법: %s -q <저장소> [개수] [열]\n", argv[0]);
+            return 1;
+        }
+        return storeTop(argv[2], argc > 3 ? atoi(argv[3]) : 100, argc > 4 ? argv[4] : "ifs");
+    }
+
+    // -j N: 병렬 로더 (N = 0이면 코어 수), -o 저장소: 결과를 열 지향 저장소에 추가,
+    // -m MB: 메모리 예산 모드 (JSON만, ext 하나씩 분석하고 결과는 임시 파일로, -j와 함께 못 씀)
+    int argi = 1, threads = -1;
+    const char *storePath = NULL;
+    for (; argi + 1 < argc; argi += 2) {
+        if (!strcmp(argv[argi], "-j")) {
+            threads = atoi(argv[argi + 1]);
+            if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+            if (threads <= 0) threads = 1;
+        } else if (!strcmp(argv[argi], "-o")) {
+            storePath = argv[argi + 1];
+        } else if (!strcmp(argv[argi], "-m")) {
+            long mb = atol(argv[argi + 1]);
+            spillSetBudget((mb > 0 ? mb : 1) * 1024 * 1024);
+        } else {
+            break;
+        }
+    }
+    const char *path = argi < argc ? argv[argi] : "ast.json";
+    if (spillBudget() && threads > 0) {
+        fprintf(stderr, "-m과 -j는 함께 쓸 수 없음 (병렬 로더는 전체 트리를 메모리에 올린다)\n");
+        return 1;
+    }
+    if (spillBudget() && isCSource(path)) {
+        // C 프론트엔드는 파일 전체를 토큰으로 만든 뒤 파싱해서 예산을 지킬 수 없다
+        fprintf(stderr, "-m은 JSON 입력에만 쓸 수 있음 (C 소스는 전체를 메모리에 올린다)\n");
+        return 1;
+    }
 
-    char *data = malloc(sz + 1);
-    fread(data, 1, sz, fp);
-    data[sz] = '\0';
-    fclose(fp);
+    registerPass(&ifPass);
+    registerPass(&effectsPass);
+    registerPass(&clonePass);
 
-    cJSON *root = cJSON_Parse(data);
-    free(data);
-    if (!root) {
+    int ok;
+    if (spillBudget()) {
+        // ext 항목 하나씩. 레코드 쓰기 실패도 실패로 본다
+        int spillOk = 1;
+        ok = loadExt(path, analyzeSpill, &spillOk) && spillOk && spillPropagate();
+        if (!ok) return 1;
+    } else if (isCSource(path)) {
+        // C 소스는 직접 파싱 (-j는 JSON 입력에만 적용)
+        if (!parseCFile(path, analyzeNode, NULL)) return 1;
+        ok = 1;
+    } else if (threads > 0) {
+        ParLoad pl;
+        ok = parLoad(path, threads, &pl);
+        if (ok) {
+            traverse(pl.root);
+            parFree(&pl);
+        }
+    } else {
+        FILE *fp = fopen(path, "r");
+        if (!fp) {
+            perror("파일 열기 실패");
+            return 1;
+        }
+        ok = streamExt(fp, analyzeNode, NULL);
+        fclose(fp);
+    }
+    if (!ok) {
         fprintf(stderr, "JSON 파싱 실패\n");
         return 1;
     }
 
-    traverse(root);
-    cJSON_Delete(root);
+    if (!spillBudget()) propagateEffects();
+    if (storePath && !storeAppend(storePath, path)) return 1;
 
     // 출력
     printf("==== 함수 분석 결과 ====\n");
-    printf("총 %d개 함수\n", funcCnt);
-    for (int i = 0; i < funcCnt; i++) {
-        Func *f = &funcs[i];
-        printf("\n[%d] %s\n", i + 1, f->name);
-        printf("  - 반환 타입: %s\n", f->retType);
+    printf("총 %d개 함수\n", resultCnt());
+    FuncIter it = {0};
+    for (Func fn, *f = &fn; funcNext(&it, f);) {
+        printf("\n[%d] %s\n", it.i, f->name);
+        printf("  - 반환 타입: %s\n", typeStr(f->retType));
         printf("  - 파라미터 %d개:\n", f->argc);
         for (int j = 0; j < f->argc; j++) {
-            printf("    - %s %s\n", f->args[j].type, f->args[j].name);
+            char decl[512];
+            typeDecl(f->args[j].type, f->args[j].name, decl, sizeof(decl));
+            printf("    - %s\n", decl);
         }
         printf("  - if문 개수: %d\n", f->ifs);
+        const Effects *e = funcEffects(&it, f);
+        if (e) {
+            printGlobals("전역 읽기", &e->rd);
+            printGlobals("전역 쓰기", &e->wr);
+        }
     }
 
-    return 0;
+    CloneClass *clones;
+    int nclones = findClones(&clones);
+    printf("\n==== 클론 후보 ====\n");
+    for (int i = 0; i < nclones; i++) {
+        printf("  - %d곳, 유사도 %.2f 이상\n", clones[i].n, (double)clones[i].same / CLONE_K);
+        for (int k = 0; k < clones[i].n; k++) {
+            const char *func, *coord;
+            cloneWhere(clones[i].units[k], &func, &coord);
+            printf("    - %s (%s, %s)\n", func, cloneUnits[clones[i].units[k]].kind, coord);
+        }
+    }
+    printf("총 %d그룹\n", nclones);
+    freeClones(clones, nclones);
+
+    return spillFailed();
 }
 
@@ -0,0 +1,161 @@
+// analyzer.c / cfront.c / spill.c / store.c 가 함께 쓰는 타입과 함수
+#ifndef ANALYZER_H
+#define ANALYZER_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <cjson/cJSON.h>
+
+// 매크로 정의
+#define OBJ(o, key) cJSON_GetObjectItem(o, key)
+#define ARR(o, idx) cJSON_GetArrayItem(o, idx)
+#define IS_STR(n) (cJSON_IsString(n))
+#define IS_ARR(n) (cJSON_IsArray(n))
+#define ARR_SIZE(a) cJSON_GetArraySize(a)
+
+#define PUSH(arr, n, cap, v) do { \
+        if ((n) == (cap)) { \
+            (cap) = (cap) ? (cap) * 2 : 16; \
+            (arr) = realloc((arr), (cap) * sizeof(*(arr))); \
+        } \
+        (arr)[(n)++] = (v); \
+    } while (0)
+
+typedef struct {
+    int type;       // 타입 id
+    char *name;
+} Param;
+
+typedef struct {
+    char *name;
+    int type;       // 함수 타입 id (시그니처 비교용)
+    int retType;
+    int ifs;
+    int defined;    // FuncDef 여부
+    int argc;
+    Param args[10]; // 최대 10개
+} Func;
+
+extern Func *funcs;
+extern int funcCnt, funcCap;
+
+// ===== analyzer.c =====
+
+// 오픈 어드레싱 문자열 -> int 맵 (키는 복사해서 보관)
+typedef struct {
+    char **keys;
+    int *vals;
+    int cap, cnt;
+} StrMap;
+
+uint64_t hashStr(const char *s);
+int mapGet(StrMap *m, const char *key);
+void mapPut(StrMap *m, const char *key, int val);
+void mapFree(StrMap *m);
+
+const char *astType(cJSON *n);
+const char *typeStr(int id);
+void freeFunc(Func *f);
+void visitExt(cJSON *node);
+
+typedef struct {
+    uint64_t *w;
+    int n;          // 워드 수
+} Bits;
+
+typedef struct {
+    char *name;
+    int defined;
+    Bits rd, wr;
+    int *callees;
+    int ncallees, calleeCap;
+} Effects;
+
+extern char **globalNames;
+extern int globalCnt;
+extern Effects *effs;
+extern int effCnt;
+const Effects *effectsOf(const char *name);
+void effReset(void);
+
+#define CLONE_K 64              // MinHash 해시 수
+#define CLONE_MIN_SHINGLES 10   // 이보다 작은 단위는 비교하지 않는다
+
+typedef struct {
+    char *func;         // 소속 함수 이름 (예산 모드에서 내보낸 뒤에는 NULL)
+    const char *kind;   // FuncDef/If/While/...
+    char *coord;
+    int fn;             // 함수 번호
+    int parent;         // 감싸는 단위, 없으면 -1
+    int pre, post;      // 함수 안 전위 순서 구간 (포함 관계 판정용)
+    int nshingles;
+    uint64_t rec;       // 예산 모드: 임시 파일 안 레코드 위치
+} CloneUnit;
+
+extern CloneUnit *cloneUnits;
+extern int cloneCnt, cloneCap;
+extern uint64_t (*cloneMh)[CLONE_K];  // 단위 u의 스케치는 cloneMh[u - cloneBase]
+extern int cloneBase;
+
+// 파싱된 ext 원소를 받는 콜백. 노드를 보관하면 1을 반환한다 (아니면 스트림이 해제)
+typedef int (*NodeFn)(cJSON *node, void *ctx);
+
+int streamExt(FILE *fp, NodeFn fn, void *ctx);
+
+// ===== cfront.c: 네이티브 C 프론트엔드 =====
+
+int parseCFile(const char *path, NodeFn fn, void *ctx);
+int isCSource(const char *path);
+int loadExt(const char *path, NodeFn fn, void *ctx);
+
+// ===== spill.c: 메모리 예산 모드 =====
+
+typedef struct {
+    uint8_t *p;
+    size_t len, cap;
+} ByteBuf;
+
+// 임시 파일 하나. 쓰기는 mem에 모았다가 한꺼번에, 읽기는 창 단위로.
+// 위치는 파일과 mem을 이은 논리 위치다
+typedef struct {
+    ByteBuf mem;        // 아직 파일로 안 나간 내용
+    int fd;
+    uint64_t len;       // 파일에 쓴 길이
+    ByteBuf win;        // 읽기 창
+    uint64_t winAt;     // 창의 파일 위치
+} SpillFile;
+
+#define SPILL_FILE_INIT {{0}, -1, 0, {0}, 0}
+
+typedef struct {
+    int i;
+    uint64_t off;   // 예산 모드: 다음 레코드 위치
+    uint64_t rec;   // 방금 읽은 레코드 위치
+    int defs;       // 지나온 정의 레코드 수
+    int set;        // 방금 읽은 함수의 전역 집합 번호, 정의가 아니면 -1
+} FuncIter;
+
+size_t bufPut(ByteBuf *b, const void *src, size_t n);
+uint64_t spillPut(SpillFile *f, const void *src, size_t n);
+int spillFull(SpillFile *f);
+int spillPread(SpillFile *f, void *dst, size_t n, uint64_t off);
+
+void spillSetBudget(size_t bytes);
+size_t spillBudget(void);
+int spillFailed(void);
+const uint64_t *spillSketch(int u, uint64_t *buf);
+void spillCloneWhere(int u, const char **func, const char **coord);
+int analyzeSpill(cJSON *node, void *ctx);
+int spillPropagate(void);
+
+int resultCnt(void);
+int funcNext(FuncIter *it, Func *f);
+const Effects *funcEffects(const FuncIter *it, const Func *f);
+
+// ===== store.c: 결과 저장소 =====
+
+int storeAppend(const char *path, const char *input);
+int storeTop(const char *path, int n, const char *col);
+
+#endif
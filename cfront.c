@@ -0,0 +1,1331 @@
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include "analyzer.h"
+
+// ===== 네이티브 C 프론트엔드 =====
+// 전처리된 .c/.i 파일을 직접 렉싱/파싱해 pycparser JSON과 같은 모양의 노드
+// (FileAST, FuncDef, Decl, If, While, BinaryOp, ...)를 만든다. 키 순서도
+// JSON(sort_keys)과 같아서 패스와 diff가 두 경로에서 같은 결과를 낸다.
+// coord는 토큰 위치 기준이라 pycparser와 열 번호가 다를 수 있다.
+// #pragma는 줄 나머지를 한 토큰으로 받아 Pragma 노드로, 그 밖의 지시문은 무시한다.
+enum { TK_EOF, TK_ID, TK_NUM, TK_CHAR, TK_STR, TK_PUNCT, TK_PRAGMA };
+
+typedef struct {
+    int kind;
+    const char *s;      // NUL로 끝나는 토큰 텍스트
+    const char *file;
+    int line, col;
+} Tok;
+
+#define MAX_DECLR 32
+
+typedef struct {
+    Tok *toks;
+    int ntoks, pos;
+    char *text;         // 토큰 텍스트 저장소
+    StrMap typedefs;    // 이름 -> 1 typedef, 0 그 밖의 이름 (안쪽 스코프에서 가림)
+    const char **undoNames; // 스코프를 닫을 때 되돌릴 이전 값
+    int *undoVals;
+    int nundo, undoCap;
+    int *scopes;        // 스코프 시작 시점의 nundo
+    int nscopes, scopeCap;
+    jmp_buf fail;
+} CParser;
+
+static const char *const cPuncts[] = {
+    "...", "<<=", ">>=", "->", "++", "--", "<<", ">>", "<=", ">=", "==", "!=", "&&", "||",
+    "*=", "/=", "%=", "+=", "-=", "&=", "^=", "|=", NULL,
+};
+
+static int isIdChar(char c) {
+    return c == '_' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+static void cError(CParser *P, Tok *t, const char *msg) {
+    fprintf(stderr, "%s:%d:%d: 구문 오류: %s (근처: '%s')\n", t->file, t->line, t->col, msg, t->s);
+    longjmp(P->fail, 1);
+}
+
+// 전처리된 소스를 토큰 배열로. # 줄 표시(# 12 "a.c")로 파일/줄 번호를 따라간다
+static int cLex(CParser *P, const char *src, size_t len, const char *path) {
+    P->text = malloc(len * 2 + strlen(path) + 16);
+    char *out = P->text;
+    strcpy(out, path);
+    const char *file = out;
+    out += strlen(path) + 1;
+
+    int cap = 1024, line = 1, bol = 1;
+    P->toks = malloc(cap * sizeof(Tok));
+    const char *p = src, *end = src + len, *lineStart = src;
+
+    while (p < end) {
+        char c = *p;
+        if (c == '\n') {
+            p++;
+            line++;
+            lineStart = p;
+            bol = 1;
+            continue;
+        }
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v') {
+            p++;
+            continue;
+        }
+        if (c == '\\' && p + 1 < end && p[1] == '\n') {
+            p += 2;
+            line++;
+            lineStart = p;
+            continue;
+        }
+        if (c == '/' && p + 1 < end && p[1] == '/') {
+            while (p < end && *p != '\n') p++;
+            continue;
+        }
+        if (c == '/' && p + 1 < end && p[1] == '*') {
+            for (p += 2; p + 1 < end && !(p[0] == '*' && p[1] == '/'); p++) {
+                if (*p == '\n') {
+                    line++;
+                    lineStart = p + 1;
+                }
+            }
+            p += 2;
+            continue;
+        }
+        if (c == '#' && bol) {
+            // # <줄> "파일" / #line <줄> "파일", 나머지 지시문은 무시
+            const char *q = p + 1;
+            while (q < end && (*q == ' ' || *q == '\t')) q++;
+            if (end - q >= 6 && !strncmp(q, "pragma", 6) && (end - q == 6 || !isIdChar(q[6]))) {
+                // 앞 공백만 떼고 줄 끝까지 (pycparser PPPRAGMASTR)
+                for (q += 6; q < end && (*q == ' ' || *q == '\t'); q++);
+                const char *e = q;
+                while (e < end && *e != '\n') e++;
+                if (P->ntoks + 1 >= cap) P->toks = realloc(P->toks, (cap *= 2) * sizeof(Tok));
+                Tok *t = &P->toks[P->ntoks++];
+                t->kind = TK_PRAGMA;
+                t->file = file;
+                t->line = line;
+                t->col = (int)(q - lineStart) + 1;
+                memcpy(out, q, e - q);
+                out[e - q] = '\0';
+                t->s = out;
+                out += e - q + 1;
+                p = e;
+                continue;
+            }
+            if (end - q > 4 && !strncmp(q, "line", 4) && !isIdChar(q[4])) q += 4;
+            while (q < end && (*q == ' ' || *q == '\t')) q++;
+            if (q < end && *q >= '0' && *q <= '9') {
+                int n = (int)strtol(q, (char **)&q, 10);
+                while (q < end && (*q == ' ' || *q == '\t')) q++;
+                if (q < end && *q == '"') {
+                    const char *f = ++q;
+                    while (q < end && *q != '"' && *q != '\n') q++;
+                    memcpy(out, f, q - f);
+                    out[q - f] = '\0';
+                    file = out;
+                    out += q - f + 1;
+                }
+                line = n - 1; // 다음 줄이 n
+            }
+            while (p < end && *p != '\n') p++;
+            continue;
+        }
+        bol = 0;
+
+        if (P->ntoks + 1 >= cap) P->toks = realloc(P->toks, (cap *= 2) * sizeof(Tok));
+        Tok *t = &P->toks[P->ntoks++];
+        t->file = file;
+        t->line = line;
+        t->col = (int)(p - lineStart) + 1;
+        const char *s = p;
+
+        if (isIdChar(c) && !(c >= '0' && c <= '9')) {
+            while (p < end && isIdChar(*p)) p++;
+            t->kind = TK_ID;
+            // L"..", u8'..' 같은 접두사가 붙은 문자/문자열
+            if (p < end && (*p == '"' || *p == '\'') && (p - s == 1 || (p - s == 2 && s[0] == 'u' && s[1] == '8')) &&
+                strchr("LuU", s[0])) {
+                c = *p;
+                goto quoted;
+            }
+        } else if ((c >= '0' && c <= '9') || (c == '.' && p + 1 < end && p[1] >= '0' && p[1] <= '9')) {
+            while (p < end) {
+                if ((*p == '+' || *p == '-') && strchr("eEpP", p[-1]) &&
+                    !(s[0] == '0' && (s[1] == 'x' || s[1] == 'X') && strchr("eE", p[-1]))) {
+                    p++;
+                } else if (isIdChar(*p) || *p == '.') {
+                    p++;
+                } else {
+                    break;
+                }
+            }
+            t->kind = TK_NUM;
+        } else if (c == '"' || c == '\'') {
+        quoted:
+            t->kind = c == '"' ? TK_STR : TK_CHAR;
+            for (p++; p < end && *p != c && *p != '\n'; p++) {
+                if (*p == '\\' && p + 1 < end) p++;
+            }
+            if (p >= end || *p != c) {
+                t->s = "";
+                fprintf(stderr, "%s:%d:%d: 구문 오류: 닫히지 않은 따옴표\n", file, t->line, t->col);
+                return 0;
+            }
+            p++;
+        } else {
+            t->kind = TK_PUNCT;
+            int n = 1;
+            for (const char *const *q = cPuncts; *q; q++) {
+                size_t l = strlen(*q);
+                if ((size_t)(end - p) >= l && !strncmp(p, *q, l)) {
+                    n = (int)l;
+                    break;
+                }
+            }
+            p += n;
+        }
+
+        memcpy(out, s, p - s);
+        out[p - s] = '\0';
+        t->s = out;
+        out += p - s + 1;
+    }
+
+    Tok *t = &P->toks[P->ntoks];
+    t->kind = TK_EOF;
+    t->s = "";
+    t->file = file;
+    t->line = line;
+    t->col = (int)(p - lineStart) + 1;
+    return 1;
+}
+
+static Tok *cur(CParser *P) {
+    return &P->toks[P->pos];
+}
+
+static Tok *peekTok(CParser *P, int k) {
+    return P->pos + k < P->ntoks ? &P->toks[P->pos + k] : &P->toks[P->ntoks];
+}
+
+static int tokIs(Tok *t, const char *s) {
+    return (t->kind == TK_ID || t->kind == TK_PUNCT) && !strcmp(t->s, s);
+}
+
+static int is(CParser *P, const char *s) {
+    return tokIs(cur(P), s);
+}
+
+static Tok *advance(CParser *P) {
+    Tok *t = cur(P);
+    if (t->kind != TK_EOF) P->pos++;
+    return t;
+}
+
+static int accept(CParser *P, const char *s) {
+    if (!is(P, s)) return 0;
+    P->pos++;
+    return 1;
+}
+
+static Tok *expect(CParser *P, const char *s) {
+    if (!is(P, s)) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "'%s' 필요", s);
+        cError(P, cur(P), msg);
+    }
+    return advance(P);
+}
+
+// --- 노드 생성 ---
+
+// 키를 정렬된 위치에 넣는다 (pycparser JSON의 sort_keys 순서)
+static void put(cJSON *n, const char *key, cJSON *v) {
+    if (!v) v = cJSON_CreateNull();
+    cJSON_AddItemToObject(n, key, v);
+    cJSON *pos = n->child;
+    while (pos != v && strcmp(pos->string, key) < 0) pos = pos->next;
+    if (pos == v) return;
+
+    // 끝에 붙은 v를 떼어 pos 앞에 넣는다
+    cJSON *last = v->prev;
+    last->next = NULL;
+    n->child->prev = last;
+    if (pos == n->child) {
+        v->prev = last;
+        n->child = v;
+    } else {
+        v->prev = pos->prev;
+        pos->prev->next = v;
+    }
+    v->next = pos;
+    pos->prev = v;
+}
+
+static void putStr(cJSON *n, const char *key, const char *s) {
+    put(n, key, s ? cJSON_CreateString(s) : NULL);
+}
+
+// 자식 리스트: 비어 있으면 JSON처럼 null
+static void putKids(cJSON *n, const char *key, cJSON *arr) {
+    if (!ARR_SIZE(arr)) {
+        cJSON_Delete(arr);
+        arr = NULL;
+    }
+    put(n, key, arr);
+}
+
+static cJSON *strList(const char *const *v, int n) {
+    cJSON *a = cJSON_CreateArray();
+    for (int i = 0; i < n; i++) cJSON_AddItemToArray(a, cJSON_CreateString(v[i]));
+    return a;
+}
+
+static cJSON *mk(const char *nt, Tok *at) {
+    cJSON *n = cJSON_CreateObject();
+    putStr(n, "_nodetype", nt);
+    if (at) {
+        char coord[512];
+        snprintf(coord, sizeof(coord), "%s:%d:%d", at->file, at->line, at->col);
+        putStr(n, "coord", coord);
+    } else {
+        put(n, "coord", NULL);
+    }
+    return n;
+}
+
+static cJSON *mkId(Tok *t) {
+    cJSON *n = mk("ID", t);
+    putStr(n, "name", t->s);
+    return n;
+}
+
+static cJSON *mkPragma(Tok *t) {
+    cJSON *n = mk("Pragma", t);
+    putStr(n, "string", t->s);
+    return n;
+}
+
+// --- 선언 ---
+
+typedef struct {
+    const char *names[8];   // 타입 지정자 (IdentifierType.names)
+    int nnames;
+    cJSON *tag;             // struct/union/enum 노드
+    const char *quals[8];
+    int nquals;
+    const char *storage[4];
+    int nstorage;
+    const char *funcspec[4];
+    int nfuncspec;
+    Tok *at;
+} Spec;
+
+typedef struct {
+    cJSON *mods[MAX_DECLR]; // 바깥쪽부터 PtrDecl/ArrayDecl/FuncDecl
+    int n;
+    cJSON *td;              // 맨 안쪽 TypeDecl
+    Tok *name;
+} Declr;
+
+static cJSON *parseExpr(CParser *P);
+static cJSON *parseAssign(CParser *P);
+static cJSON *parseCastExpr(CParser *P);
+static cJSON *parseCompound(CParser *P, cJSON *params);
+static cJSON *parseStmt(CParser *P);
+static cJSON *parseInitializer(CParser *P);
+static void parseSpec(CParser *P, Spec *sp, int allowStorage);
+static void parseDeclarator(CParser *P, Declr *d, int abstract);
+static cJSON *buildDecl(CParser *P, Spec *sp, Declr *d, cJSON *init, cJSON *bitsize);
+
+static const char *const cTypeKws[] = {
+    "void", "char", "short", "int", "long", "float", "double", "signed", "unsigned",
+    "_Bool", "_Complex", NULL,
+};
+
+static int inList(const char *const *l, const char *s) {
+    for (; *l; l++) {
+        if (!strcmp(*l, s)) return 1;
+    }
+    return 0;
+}
+
+// GNU 별칭은 표준 키워드로
+static const char *qualOf(Tok *t) {
+    if (t->kind != TK_ID) return NULL;
+    const char *s = t->s;
+    if (!strcmp(s, "const") || !strcmp(s, "__const")) return "const";
+    if (!strcmp(s, "volatile") || !strcmp(s, "__volatile__")) return "volatile";
+    if (!strcmp(s, "restrict") || !strcmp(s, "__restrict") || !strcmp(s, "__restrict__")) return "restrict";
+    if (!strcmp(s, "_Atomic")) return "_Atomic";
+    return NULL;
+}
+
+static int isTypedefName(CParser *P, Tok *t) {
+    return t->kind == TK_ID && mapGet(&P->typedefs, t->s) == 1;
+}
+
+static int isTypeStart(CParser *P, Tok *t) {
+    if (t->kind != TK_ID) return 0;
+    return inList(cTypeKws, t->s) || !strcmp(t->s, "struct") || !strcmp(t->s, "union") ||
+           !strcmp(t->s, "enum") || qualOf(t) || isTypedefName(P, t);
+}
+
+static const char *const cStorageKws[] = {"typedef", "extern", "static", "auto", "register", "_Thread_local", NULL};
+static const char *const cFuncKws[] = {"inline", "__inline", "__inline__", "_Noreturn", NULL};
+
+// typedef 이름을 뺀 선언 키워드
+static int isDeclKeyword(Tok *t) {
+    if (t->kind != TK_ID) return 0;
+    return inList(cTypeKws, t->s) || !strcmp(t->s, "struct") || !strcmp(t->s, "union") ||
+           !strcmp(t->s, "enum") || qualOf(t) || inList(cStorageKws, t->s) || inList(cFuncKws, t->s) ||
+           !strcmp(t->s, "__extension__");
+}
+
+static int isDeclStart(CParser *P, Tok *t) {
+    return isDeclKeyword(t) || isTypedefName(P, t);
+}
+
+// --- 스코프 ---
+
+static void scopePush(CParser *P) {
+    PUSH(P->scopes, P->nscopes, P->scopeCap, P->nundo);
+}
+
+static void scopePop(CParser *P) {
+    int mark = P->scopes[--P->nscopes];
+    while (P->nundo > mark) {
+        P->nundo--;
+        mapPut(&P->typedefs, P->undoNames[P->nundo], P->undoVals[P->nundo]);
+    }
+}
+
+// 현재 스코프에서 name을 typedef(1) 또는 일반 이름(0)으로 선언
+static void scopeBind(CParser *P, const char *name, int isTypedef) {
+    int old = mapGet(&P->typedefs, name);
+    if (old == isTypedef || (!isTypedef && old != 1)) return;
+    if (P->nscopes) {
+        if (P->nundo == P->undoCap) {
+            P->undoCap = P->undoCap ? P->undoCap * 2 : 16;
+            P->undoNames = realloc(P->undoNames, P->undoCap * sizeof(char *));
+            P->undoVals = realloc(P->undoVals, P->undoCap * sizeof(int));
+        }
+        P->undoNames[P->nundo] = name;
+        P->undoVals[P->nundo++] = old;
+    }
+    mapPut(&P->typedefs, name, isTypedef);
+}
+
+// 파라미터 이름을 현재 스코프에 (함수 본문, 프로토타입 스코프)
+static void bindParams(CParser *P, cJSON *list) {
+    cJSON *p;
+    cJSON_ArrayForEach(p, OBJ(list, "params")) {
+        cJSON *name = OBJ(p, "name");
+        if (IS_STR(name)) scopeBind(P, name->valuestring, 0);
+    }
+}
+
+// __attribute__((...)), __asm__("...") 는 건너뛴다
+static int skipGnu(CParser *P) {
+    Tok *t = cur(P);
+    if (t->kind != TK_ID) return 0;
+    if (!strcmp(t->s, "__extension__")) {
+        advance(P);
+        return 1;
+    }
+    if (strcmp(t->s, "__attribute__") && strcmp(t->s, "__attribute") && strcmp(t->s, "__asm__") &&
+        strcmp(t->s, "__asm") && strcmp(t->s, "asm")) {
+        return 0;
+    }
+    advance(P);
+    expect(P, "(");
+    for (int depth = 1; depth;) {
+        if (cur(P)->kind == TK_EOF) cError(P, cur(P), "닫히지 않은 괄호");
+        if (is(P, "(")) depth++;
+        else if (is(P, ")")) depth--;
+        advance(P);
+    }
+    return 1;
+}
+
+static cJSON *parseStructUnion(CParser *P) {
+    Tok *kw = advance(P);
+    cJSON *n = mk(!strcmp(kw->s, "struct") ? "Struct" : "Union", kw);
+    while (skipGnu(P));
+    Tok *name = cur(P)->kind == TK_ID && !is(P, "{") ? advance(P) : NULL;
+    putStr(n, "name", name ? name->s : NULL);
+    if (!accept(P, "{")) {
+        if (!name) cError(P, cur(P), "구조체 이름이나 본문 필요");
+        put(n, "decls", NULL);
+        return n;
+    }
+
+    cJSON *decls = cJSON_CreateArray();
+    while (!accept(P, "}")) {
+        if (accept(P, ";")) continue;
+        if (cur(P)->kind == TK_PRAGMA) {
+            cJSON_AddItemToArray(decls, mkPragma(advance(P)));
+            continue;
+        }
+        Spec sp;
+        parseSpec(P, &sp, 0);
+        if (is(P, ";")) {
+            // 이름 없는 struct/union 멤버
+            if (!sp.tag) cError(P, cur(P), "멤버 선언자 필요");
+            Declr d = {0};
+            cJSON_AddItemToArray(decls, buildDecl(P, &sp, &d, NULL, NULL));
+        }
+        while (!is(P, ";")) {
+            Declr d = {0};
+            if (!is(P, ":")) parseDeclarator(P, &d, 0);
+            cJSON *bits = accept(P, ":") ? parseCastExpr(P) : NULL;
+            while (skipGnu(P));
+            cJSON_AddItemToArray(decls, buildDecl(P, &sp, &d, NULL, bits));
+            if (!accept(P, ",")) break;
+        }
+        cJSON_Delete(sp.tag);
+        expect(P, ";");
+    }
+    putKids(n, "decls", decls);
+    return n;
+}
+
+static cJSON *parseEnum(CParser *P) {
+    Tok *kw = advance(P);
+    cJSON *n = mk("Enum", kw);
+    while (skipGnu(P));
+    Tok *name = cur(P)->kind == TK_ID && !is(P, "{") ? advance(P) : NULL;
+    putStr(n, "name", name ? name->s : NULL);
+    if (!is(P, "{")) {
+        if (!name) cError(P, cur(P), "열거형 이름이나 본문 필요");
+        put(n, "values", NULL);
+        return n;
+    }
+
+    cJSON *list = mk("EnumeratorList", advance(P));
+    cJSON *items = cJSON_CreateArray();
+    while (!accept(P, "}")) {
+        Tok *id = advance(P);
+        if (id->kind != TK_ID) cError(P, id, "열거자 이름 필요");
+        cJSON *e = mk("Enumerator", id);
+        putStr(e, "name", id->s);
+        put(e, "value", accept(P, "=") ? parseAssign(P) : NULL);
+        cJSON_AddItemToArray(items, e);
+        if (!accept(P, ",")) {
+            expect(P, "}");
+            break;
+        }
+    }
+    putKids(list, "enumerators", items);
+    put(n, "values", list);
+    return n;
+}
+
+static void parseSpec(CParser *P, Spec *sp, int allowStorage) {
+    memset(sp, 0, sizeof(Spec));
+    sp->at = cur(P);
+    for (;;) {
+        Tok *t = cur(P);
+        const char *q;
+        if (skipGnu(P)) continue;
+        if (t->kind != TK_ID) break;
+
+        if (inList(cStorageKws, t->s)) {
+            if (!allowStorage) cError(P, t, "여기서는 저장 클래스를 쓸 수 없음");
+            if (sp->nstorage < 4) sp->storage[sp->nstorage++] = t->s;
+        } else if ((q = qualOf(t))) {
+            if (sp->nquals < 8) sp->quals[sp->nquals++] = q;
+        } else if (inList(cFuncKws, t->s)) {
+            if (sp->nfuncspec < 4) sp->funcspec[sp->nfuncspec++] = strncmp(t->s, "__", 2) ? t->s : "inline";
+        } else if (inList(cTypeKws, t->s)) {
+            if (sp->nnames < 8) sp->names[sp->nnames++] = t->s;
+        } else if (!strcmp(t->s, "struct") || !strcmp(t->s, "union")) {
+            if (sp->tag || sp->nnames) cError(P, t, "타입이 여러 개");
+            sp->tag = parseStructUnion(P);
+            continue;
+        } else if (!strcmp(t->s, "enum")) {
+            if (sp->tag || sp->nnames) cError(P, t, "타입이 여러 개");
+            sp->tag = parseEnum(P);
+            continue;
+        } else if (!sp->nnames && !sp->tag && isTypedefName(P, t)) {
+            sp->names[sp->nnames++] = t->s;
+        } else {
+            break;
+        }
+        advance(P);
+    }
+}
+
+// 파라미터 이름은 프로토타입 스코프 안에서만 typedef를 가린다
+static cJSON *parseParams(CParser *P, Tok *at) {
+    cJSON *list = mk("ParamList", at);
+    cJSON *params = cJSON_CreateArray();
+    Tok *t = cur(P), *nt = peekTok(P, 1);
+    if (t->kind == TK_ID && !isDeclStart(P, t) && (tokIs(nt, ",") || tokIs(nt, ")"))) {
+        // K&R 식별자 목록: 이름만 ID로, 타입은 함수 정의의 param_decls에 있다
+        do {
+            t = advance(P);
+            if (t->kind != TK_ID) cError(P, t, "파라미터 이름 필요");
+            cJSON_AddItemToArray(params, mkId(t));
+        } while (accept(P, ","));
+        putKids(list, "params", params);
+        return list;
+    }
+    scopePush(P);
+    do {
+        if (is(P, "...")) {
+            cJSON_AddItemToArray(params, mk("EllipsisParam", advance(P)));
+            break;
+        }
+        Spec sp;
+        parseSpec(P, &sp, 1);
+        if (!sp.nnames && !sp.tag) sp.names[sp.nnames++] = "int";
+
+        Declr d = {0};
+        Tok *dt = cur(P);
+        parseDeclarator(P, &d, 1);
+        if (d.name) {
+            scopeBind(P, d.name->s, 0);
+            cJSON_AddItemToArray(params, buildDecl(P, &sp, &d, NULL, NULL));
+        } else {
+            // 이름 없는 파라미터는 Typename
+            cJSON *tn = mk("Typename", dt);
+            put(tn, "align", NULL);
+            put(tn, "name", NULL);
+            put(tn, "quals", strList(sp.quals, sp.nquals));
+            cJSON *inner = buildDecl(P, &sp, &d, NULL, NULL);
+            put(tn, "type", cJSON_DetachItemFromObject(inner, "type"));
+            cJSON_Delete(inner);
+            cJSON_AddItemToArray(params, tn);
+        }
+        cJSON_Delete(sp.tag);
+    } while (accept(P, ","));
+    scopePop(P);
+    putKids(list, "params", params);
+    return list;
+}
+
+static void declrPush(CParser *P, Declr *d, cJSON *mod) {
+    if (d->n == MAX_DECLR) cError(P, cur(P), "선언자가 너무 깊음");
+    d->mods[d->n++] = mod;
+}
+
+// 포인터 접두, (중첩 선언자) 또는 이름, [..]/(..) 접미 순으로 읽는다.
+// 결과 체인은 바깥쪽부터 [중첩 선언자의 수식] [접미] [포인터(뒤에서부터)] TypeDecl
+static void parseDeclarator(CParser *P, Declr *d, int abstract) {
+    cJSON *ptrs[MAX_DECLR];
+    int np = 0;
+    while (is(P, "*")) {
+        cJSON *p = mk("PtrDecl", advance(P));
+        const char *quals[8];
+        int nq = 0;
+        for (const char *q; (q = qualOf(cur(P))) || skipGnu(P);) {
+            if (q) {
+                if (nq < 8) quals[nq++] = q;
+                advance(P);
+            }
+        }
+        put(p, "quals", strList(quals, nq));
+        if (np == MAX_DECLR) cError(P, cur(P), "선언자가 너무 깊음");
+        ptrs[np++] = p;
+    }
+    while (skipGnu(P));
+
+    memset(d, 0, sizeof(Declr));
+    Tok *nt = peekTok(P, 1);
+    if (is(P, "(") && !(abstract && (isTypeStart(P, nt) || tokIs(nt, ")") || tokIs(nt, "...")))) {
+        advance(P);
+        parseDeclarator(P, d, abstract);
+        expect(P, ")");
+    } else {
+        Tok *t = cur(P);
+        // 지정자 뒤의 typedef 이름은 다시 선언되는 이름이다 (int T;)
+        int named = t->kind == TK_ID && !isDeclKeyword(t);
+        if (!named && !abstract) cError(P, t, "선언자 이름 필요");
+        d->td = mk("TypeDecl", named ? t : NULL);
+        put(d->td, "align", NULL);
+        putStr(d->td, "declname", named ? t->s : NULL);
+        if (named) d->name = advance(P);
+    }
+
+    for (;;) {
+        if (is(P, "[")) {
+            cJSON *a = mk("ArrayDecl", advance(P));
+            const char *quals[8];
+            int nq = 0;
+            for (const char *q; (q = qualOf(cur(P))) || is(P, "static");) {
+                if (nq < 8) quals[nq++] = q ? q : "static";
+                advance(P);
+            }
+            put(a, "dim", is(P, "]") ? NULL : parseAssign(P));
+            put(a, "dim_quals", strList(quals, nq));
+            expect(P, "]");
+            declrPush(P, d, a);
+        } else if (is(P, "(")) {
+            Tok *lp = advance(P);
+            cJSON *f = mk("FuncDecl", lp);
+            put(f, "args", is(P, ")") ? NULL : parseParams(P, lp));
+            expect(P, ")");
+            declrPush(P, d, f);
+        } else {
+            break;
+        }
+    }
+    while (np) declrPush(P, d, ptrs[--np]);
+    while (skipGnu(P));
+}
+
+// 선언자 체인에 기본 타입을 달고 Decl/Typedef로 만든다 (pycparser의 _fix_decl_name_type)
+static cJSON *buildDecl(CParser *P, Spec *sp, Declr *d, cJSON *init, cJSON *bitsize) {
+    (void)P;
+    int isTypedef = 0;
+    for (int i = 0; i < sp->nstorage; i++) isTypedef |= !strcmp(sp->storage[i], "typedef");
+
+    cJSON *type;
+    Tok *at = d->name;
+    if (!d->td && !d->n) {
+        // 선언자 없는 struct/union/enum 선언
+        type = sp->tag ? cJSON_Duplicate(sp->tag, 1) : NULL;
+        at = sp->at;
+    } else {
+        cJSON *base;
+        if (sp->tag) {
+            base = cJSON_Duplicate(sp->tag, 1);
+        } else {
+            base = mk("IdentifierType", sp->at);
+            put(base, "names", sp->nnames ? strList(sp->names, sp->nnames) : strList((const char *[]){"int"}, 1));
+        }
+        put(d->td, "quals", strList(sp->quals, sp->nquals));
+        put(d->td, "type", base);
+        for (int i = d->n - 1; i >= 0; i--) put(d->mods[i], "type", i == d->n - 1 ? d->td : d->mods[i + 1]);
+        type = d->n ? d->mods[0] : d->td;
+    }
+
+    cJSON *n = mk(isTypedef ? "Typedef" : "Decl", at);
+    if (!isTypedef) {
+        put(n, "align", cJSON_CreateArray());
+        put(n, "bitsize", bitsize);
+        put(n, "funcspec", strList(sp->funcspec, sp->nfuncspec));
+        put(n, "init", init);
+    }
+    putStr(n, "name", d->name ? d->name->s : NULL);
+    put(n, "quals", strList(sp->quals, sp->nquals));
+    put(n, "storage", strList(sp->storage, sp->nstorage));
+    put(n, "type", type);
+    return n;
+}
+
+// 선언 하나 (지역/전역 공통). 만들어진 Decl/Typedef를 out에 넣는다
+static void parseDeclaration(CParser *P, cJSON *out) {
+    Spec sp;
+    parseSpec(P, &sp, 1);
+    if (is(P, ";")) {
+        if (!sp.tag) cError(P, cur(P), "선언자 필요");
+        Declr d = {0};
+        cJSON_AddItemToArray(out, buildDecl(P, &sp, &d, NULL, NULL));
+    }
+    while (!is(P, ";")) {
+        Declr d;
+        parseDeclarator(P, &d, 0);
+        int isTypedef = 0;
+        for (int i = 0; i < sp.nstorage; i++) isTypedef |= !strcmp(sp.storage[i], "typedef");
+        scopeBind(P, d.name->s, isTypedef); // 초기화식에서 이미 보인다
+        cJSON *init = accept(P, "=") ? parseInitializer(P) : NULL;
+        cJSON *n = buildDecl(P, &sp, &d, init, NULL);
+        cJSON_AddItemToArray(out, n);
+        if (!accept(P, ",")) break;
+    }
+    cJSON_Delete(sp.tag);
+    expect(P, ";");
+}
+
+static cJSON *parseTypeName(CParser *P) {
+    Spec sp;
+    Tok *at = cur(P);
+    parseSpec(P, &sp, 0);
+    if (!sp.nnames && !sp.tag) cError(P, at, "타입 이름 필요");
+    Declr d;
+    parseDeclarator(P, &d, 1);
+
+    cJSON *tn = mk("Typename", at);
+    put(tn, "align", NULL);
+    put(tn, "name", NULL);
+    put(tn, "quals", strList(sp.quals, sp.nquals));
+    cJSON *inner = buildDecl(P, &sp, &d, NULL, NULL);
+    put(tn, "type", cJSON_DetachItemFromObject(inner, "type"));
+    cJSON_Delete(inner);
+    cJSON_Delete(sp.tag);
+    return tn;
+}
+
+// --- 식 ---
+
+static cJSON *parseConstant(CParser *P) {
+    Tok *t = advance(P);
+    cJSON *n = mk("Constant", t);
+    char type[32] = "int";
+    size_t len = strlen(t->s);
+
+    if (t->kind == TK_CHAR) {
+        strcpy(type, "char");
+        putStr(n, "value", t->s);
+    } else if (t->kind == TK_STR) {
+        // 이어진 문자열 리터럴은 하나로 합친다
+        size_t cap = len + 1;
+        char *v = malloc(cap);
+        strcpy(v, t->s);
+        while (cur(P)->kind == TK_STR) {
+            const char *s = advance(P)->s;
+            const char *q = strchr(s, '"');
+            size_t vl = strlen(v) - 1, sl = strlen(q + 1);
+            v = realloc(v, cap = vl + sl + 1);
+            memcpy(v + vl, q + 1, sl + 1);
+        }
+        strcpy(type, "string");
+        putStr(n, "value", v);
+        free(v);
+    } else {
+        int hex = len > 1 && t->s[0] == '0' && (t->s[1] == 'x' || t->s[1] == 'X');
+        int isFloat = strchr(t->s, '.') || (hex ? strpbrk(t->s, "pP") : strpbrk(t->s, "eE"));
+        if (isFloat) {
+            char last = t->s[len - 1];
+            strcpy(type, last == 'f' || last == 'F' ? "float" : last == 'l' || last == 'L' ? "long double" : "double");
+        } else {
+            int u = 0, l = 0;
+            for (size_t i = len > 3 ? len - 3 : 0; i < len; i++) {
+                if (t->s[i] == 'u' || t->s[i] == 'U') u++;
+                else if (t->s[i] == 'l' || t->s[i] == 'L') l++;
+            }
+            snprintf(type, sizeof(type), "%s%s%sint", u ? "unsigned " : "", l > 0 ? "long " : "", l > 1 ? "long " : "");
+        }
+        putStr(n, "value", t->s);
+    }
+    putStr(n, "type", type);
+    return n;
+}
+
+static cJSON *parsePrimary(CParser *P) {
+    Tok *t = cur(P);
+    if (t->kind == TK_NUM || t->kind == TK_CHAR || t->kind == TK_STR) return parseConstant(P);
+    if (t->kind == TK_ID && !isDeclStart(P, t)) return mkId(advance(P));
+    if (accept(P, "(")) {
+        cJSON *e = parseExpr(P);
+        expect(P, ")");
+        return e;
+    }
+    cError(P, t, "식이 필요");
+    return NULL;
+}
+
+static cJSON *parsePostfix(CParser *P, cJSON *e) {
+    for (;;) {
+        Tok *t = cur(P);
+        if (accept(P, "[")) {
+            cJSON *n = mk("ArrayRef", t);
+            put(n, "name", e);
+            put(n, "subscript", parseExpr(P));
+            expect(P, "]");
+            e = n;
+        } else if (accept(P, "(")) {
+            cJSON *n = mk("FuncCall", t);
+            cJSON *args = NULL;
+            if (!is(P, ")")) {
+                args = mk("ExprList", cur(P));
+                cJSON *list = cJSON_CreateArray();
+                do cJSON_AddItemToArray(list, parseAssign(P));
+                while (accept(P, ","));
+                putKids(args, "exprs", list);
+            }
+            expect(P, ")");
+            put(n, "args", args);
+            put(n, "name", e);
+            e = n;
+        } else if (is(P, ".") || is(P, "->")) {
+            advance(P);
+            Tok *f = advance(P);
+            if (f->kind != TK_ID) cError(P, f, "필드 이름 필요");
+            cJSON *n = mk("StructRef", t);
+            put(n, "field", mkId(f));
+            put(n, "name", e);
+            putStr(n, "type", t->s);
+            e = n;
+        } else if (is(P, "++") || is(P, "--")) {
+            advance(P);
+            cJSON *n = mk("UnaryOp", t);
+            put(n, "expr", e);
+            putStr(n, "op", !strcmp(t->s, "++") ? "p++" : "p--");
+            e = n;
+        } else {
+            return e;
+        }
+    }
+}
+
+static cJSON *mkUnary(Tok *t, const char *op, cJSON *e) {
+    cJSON *n = mk("UnaryOp", t);
+    put(n, "expr", e);
+    putStr(n, "op", op);
+    return n;
+}
+
+static cJSON *parseUnary(CParser *P) {
+    Tok *t = cur(P);
+    if (is(P, "++") || is(P, "--")) {
+        advance(P);
+        return mkUnary(t, t->s, parseUnary(P));
+    }
+    if (is(P, "&") || is(P, "*") || is(P, "+") || is(P, "-") || is(P, "~") || is(P, "!")) {
+        advance(P);
+        return mkUnary(t, t->s, parseCastExpr(P));
+    }
+    if (is(P, "sizeof") || is(P, "_Alignof")) {
+        advance(P);
+        if (is(P, "(") && isTypeStart(P, peekTok(P, 1))) {
+            advance(P);
+            cJSON *tn = parseTypeName(P);
+            expect(P, ")");
+            return mkUnary(t, t->s, tn);
+        }
+        return mkUnary(t, t->s, parseUnary(P));
+    }
+    return parsePostfix(P, parsePrimary(P));
+}
+
+static cJSON *parseCastExpr(CParser *P) {
+    if (is(P, "(") && isTypeStart(P, peekTok(P, 1))) {
+        Tok *t = advance(P);
+        cJSON *tn = parseTypeName(P);
+        expect(P, ")");
+        if (is(P, "{")) {
+            cJSON *n = mk("CompoundLiteral", t);
+            put(n, "init", parseInitializer(P));
+            put(n, "type", tn);
+            return parsePostfix(P, n);
+        }
+        cJSON *n = mk("Cast", t);
+        put(n, "expr", parseCastExpr(P));
+        put(n, "to_type", tn);
+        return n;
+    }
+    return parseUnary(P);
+}
+
+static int binPrec(Tok *t) {
+    static const char *const ops[][4] = {
+        {"||"}, {"&&"}, {"|"}, {"^"}, {"&"}, {"==", "!="}, {"<", ">", "<=", ">="},
+        {"<<", ">>"}, {"+", "-"}, {"*", "/", "%"},
+    };
+    if (t->kind != TK_PUNCT) return 0;
+    for (int i = 0; i < 10; i++) {
+        for (int j = 0; j < 4 && ops[i][j]; j++) {
+            if (!strcmp(ops[i][j], t->s)) return i + 1;
+        }
+    }
+    return 0;
+}
+
+// 우선순위 등반. 같은 우선순위는 왼쪽 결합
+static cJSON *parseBinary(CParser *P, int minPrec) {
+    cJSON *left = parseCastExpr(P);
+    for (int prec; (prec = binPrec(cur(P))) >= minPrec;) {
+        Tok *t = advance(P);
+        cJSON *n = mk("BinaryOp", t);
+        put(n, "left", left);
+        putStr(n, "op", t->s);
+        put(n, "right", parseBinary(P, prec + 1));
+        left = n;
+    }
+    return left;
+}
+
+static cJSON *parseCond(CParser *P) {
+    cJSON *c = parseBinary(P, 1);
+    Tok *t = cur(P);
+    if (!accept(P, "?")) return c;
+    cJSON *n = mk("TernaryOp", t);
+    put(n, "cond", c);
+    put(n, "iftrue", parseExpr(P));
+    expect(P, ":");
+    put(n, "iffalse", parseCond(P));
+    return n;
+}
+
+static const char *const cAssignOps[] = {"=", "*=", "/=", "%=", "+=", "-=", "<<=", ">>=", "&=", "^=", "|=", NULL};
+
+static cJSON *parseAssign(CParser *P) {
+    cJSON *lv = parseCond(P);
+    Tok *t = cur(P);
+    if (t->kind != TK_PUNCT || !inList(cAssignOps, t->s)) return lv;
+    advance(P);
+    cJSON *n = mk("Assignment", t);
+    put(n, "lvalue", lv);
+    putStr(n, "op", t->s);
+    put(n, "rvalue", parseAssign(P));
+    return n;
+}
+
+static cJSON *parseExpr(CParser *P) {
+    Tok *t = cur(P);
+    cJSON *e = parseAssign(P);
+    if (!is(P, ",")) return e;
+    cJSON *n = mk("ExprList", t);
+    cJSON *list = cJSON_CreateArray();
+    cJSON_AddItemToArray(list, e);
+    while (accept(P, ",")) cJSON_AddItemToArray(list, parseAssign(P));
+    putKids(n, "exprs", list);
+    return n;
+}
+
+static cJSON *parseInitializer(CParser *P) {
+    if (!is(P, "{")) return parseAssign(P);
+    cJSON *n = mk("InitList", advance(P));
+    cJSON *list = cJSON_CreateArray();
+    while (!accept(P, "}")) {
+        if (is(P, ".") || is(P, "[")) {
+            cJSON *ni = mk("NamedInitializer", cur(P));
+            cJSON *names = cJSON_CreateArray();
+            for (;;) {
+                if (accept(P, ".")) {
+                    Tok *f = advance(P);
+                    if (f->kind != TK_ID) cError(P, f, "필드 이름 필요");
+                    cJSON_AddItemToArray(names, mkId(f));
+                } else if (accept(P, "[")) {
+                    cJSON_AddItemToArray(names, parseCond(P));
+                    expect(P, "]");
+                } else {
+                    break;
+                }
+            }
+            expect(P, "=");
+            put(ni, "expr", parseInitializer(P));
+            putKids(ni, "name", names);
+            cJSON_AddItemToArray(list, ni);
+        } else {
+            cJSON_AddItemToArray(list, parseInitializer(P));
+        }
+        if (!accept(P, ",")) {
+            expect(P, "}");
+            break;
+        }
+    }
+    putKids(n, "exprs", list);
+    return n;
+}
+
+// --- 문 ---
+
+static cJSON *mkStmts(cJSON *s) {
+    cJSON *a = cJSON_CreateArray();
+    cJSON_AddItemToArray(a, s);
+    return a;
+}
+
+// switch 본문의 case 뒤 문장들을 그 case의 stmts로 옮긴다 (pycparser fix_switch_cases)
+static void fixSwitchCases(cJSON *sw) {
+    cJSON *body = OBJ(sw, "stmt");
+    if (strcmp(astType(body), "Compound")) return;
+
+    cJSON *items = OBJ(body, "block_items");
+    cJSON *out = cJSON_CreateArray();
+    cJSON *lastCase = NULL;
+    while (ARR_SIZE(items)) {
+        cJSON *c = cJSON_DetachItemFromArray(items, 0);
+        const char *t = astType(c);
+        if (!strcmp(t, "Case") || !strcmp(t, "Default")) {
+            cJSON_AddItemToArray(out, c);
+            // case 1: case 2: ... 처럼 중첩된 case는 펼친다
+            for (cJSON *k = c;;) {
+                cJSON *st = OBJ(k, "stmts");
+                cJSON *first = ARR(st, 0);
+                const char *ft = astType(first);
+                if (!first || (strcmp(ft, "Case") && strcmp(ft, "Default"))) break;
+                k = cJSON_DetachItemFromArray(st, ARR_SIZE(st) - 1);
+                cJSON_AddItemToArray(out, k);
+            }
+            lastCase = ARR(out, ARR_SIZE(out) - 1);
+        } else if (lastCase) {
+            cJSON_AddItemToArray(OBJ(lastCase, "stmts"), c);
+        } else {
+            cJSON_AddItemToArray(out, c);
+        }
+    }
+
+    cJSON *c;
+    cJSON_ArrayForEach(c, out) {
+        const char *t = astType(c);
+        if ((!strcmp(t, "Case") || !strcmp(t, "Default")) && !ARR_SIZE(OBJ(c, "stmts"))) {
+            cJSON_DeleteItemFromObject(c, "stmts");
+            put(c, "stmts", NULL);
+        }
+    }
+    cJSON_DeleteItemFromObject(body, "block_items");
+    putKids(body, "block_items", out);
+}
+
+// params가 있으면 함수 본문: 파라미터 이름도 본문 스코프에 넣는다
+static cJSON *parseCompound(CParser *P, cJSON *params) {
+    cJSON *n = mk("Compound", expect(P, "{"));
+    cJSON *items = cJSON_CreateArray();
+    scopePush(P);
+    if (params) bindParams(P, params);
+    while (!accept(P, "}")) {
+        if (cur(P)->kind == TK_EOF) cError(P, cur(P), "'}' 필요");
+        int label = cur(P)->kind == TK_ID && tokIs(peekTok(P, 1), ":");
+        if (!label && isDeclStart(P, cur(P))) parseDeclaration(P, items);
+        else cJSON_AddItemToArray(items, parseStmt(P));
+    }
+    scopePop(P);
+    putKids(n, "block_items", items);
+    return n;
+}
+
+// _Static_assert(식[, "메시지"]). 뒤의 ;는 읽지 않는다 (pycparser처럼 빈 문장/빈 선언)
+static cJSON *parseStaticAssert(CParser *P) {
+    cJSON *n = mk("StaticAssert", expect(P, "_Static_assert"));
+    expect(P, "(");
+    put(n, "cond", parseCond(P));
+    cJSON *msg = NULL;
+    if (accept(P, ",")) {
+        if (cur(P)->kind != TK_STR) cError(P, cur(P), "문자열 필요");
+        msg = parseConstant(P);
+    }
+    put(n, "message", msg);
+    expect(P, ")");
+    return n;
+}
+
+// 제어문 본문 앞의 #pragma는 본문과 묶어 Compound로 (pycparser pragmacomp_or_statement)
+static cJSON *parseBody(CParser *P) {
+    Tok *t = cur(P);
+    if (t->kind != TK_PRAGMA) return parseStmt(P);
+    cJSON *n = mk("Compound", t);
+    cJSON *items = cJSON_CreateArray();
+    cJSON_AddItemToArray(items, mkPragma(advance(P)));
+    cJSON_AddItemToArray(items, parseStmt(P));
+    putKids(n, "block_items", items);
+    return n;
+}
+
+static cJSON *parseParenExpr(CParser *P) {
+    expect(P, "(");
+    cJSON *e = parseExpr(P);
+    expect(P, ")");
+    return e;
+}
+
+static cJSON *parseStmt(CParser *P) {
+    Tok *t = cur(P);
+    cJSON *n;
+
+    if (is(P, "{")) return parseCompound(P, NULL);
+    if (accept(P, ";")) return mk("EmptyStatement", t);
+    if (t->kind == TK_PRAGMA) return mkPragma(advance(P));
+    if (is(P, "_Static_assert")) return parseStaticAssert(P);
+
+    if (t->kind == TK_ID && tokIs(peekTok(P, 1), ":") && strcmp(t->s, "default") && !isDeclStart(P, t)) {
+        advance(P);
+        advance(P);
+        n = mk("Label", t);
+        putStr(n, "name", t->s);
+        put(n, "stmt", parseBody(P));
+        return n;
+    }
+    if (accept(P, "if")) {
+        n = mk("If", t);
+        put(n, "cond", parseParenExpr(P));
+        put(n, "iftrue", parseStmt(P)); // pycparser도 여기서는 #pragma만 본문으로 본다
+        put(n, "iffalse", accept(P, "else") ? parseBody(P) : NULL);
+        return n;
+    }
+    if (accept(P, "while")) {
+        n = mk("While", t);
+        put(n, "cond", parseParenExpr(P));
+        put(n, "stmt", parseBody(P));
+        return n;
+    }
+    if (accept(P, "do")) {
+        n = mk("DoWhile", t);
+        put(n, "stmt", parseBody(P));
+        expect(P, "while");
+        put(n, "cond", parseParenExpr(P));
+        expect(P, ";");
+        return n;
+    }
+    if (accept(P, "for")) {
+        n = mk("For", t);
+        expect(P, "(");
+        scopePush(P); // for 선언은 본문까지만
+        if (isDeclStart(P, cur(P))) {
+            cJSON *dl = mk("DeclList", t);
+            cJSON *decls = cJSON_CreateArray();
+            parseDeclaration(P, decls);
+            putKids(dl, "decls", decls);
+            put(n, "init", dl);
+        } else {
+            put(n, "init", is(P, ";") ? NULL : parseExpr(P));
+            expect(P, ";");
+        }
+        put(n, "cond", is(P, ";") ? NULL : parseExpr(P));
+        expect(P, ";");
+        put(n, "next", is(P, ")") ? NULL : parseExpr(P));
+        expect(P, ")");
+        put(n, "stmt", parseBody(P));
+        scopePop(P);
+        return n;
+    }
+    if (accept(P, "switch")) {
+        n = mk("Switch", t);
+        put(n, "cond", parseParenExpr(P));
+        put(n, "stmt", parseBody(P));
+        fixSwitchCases(n);
+        return n;
+    }
+    if (accept(P, "case")) {
+        n = mk("Case", t);
+        put(n, "expr", parseCond(P));
+        expect(P, ":");
+        put(n, "stmts", mkStmts(parseBody(P)));
+        return n;
+    }
+    if (accept(P, "default")) {
+        n = mk("Default", t);
+        expect(P, ":");
+        put(n, "stmts", mkStmts(parseBody(P)));
+        return n;
+    }
+    if (accept(P, "goto")) {
+        Tok *l = advance(P);
+        if (l->kind != TK_ID) cError(P, l, "레이블 이름 필요");
+        n = mk("Goto", t);
+        putStr(n, "name", l->s);
+        expect(P, ";");
+        return n;
+    }
+    if (accept(P, "break") || accept(P, "continue")) {
+        expect(P, ";");
+        return mk(!strcmp(t->s, "break") ? "Break" : "Continue", t);
+    }
+    if (accept(P, "return")) {
+        n = mk("Return", t);
+        put(n, "expr", is(P, ";") ? NULL : parseExpr(P));
+        expect(P, ";");
+        return n;
+    }
+
+    n = parseExpr(P);
+    expect(P, ";");
+    return n;
+}
+
+// --- 최상위 ---
+
+// 최상위 선언/함수 정의 하나를 읽어 fn에 넘긴다
+static void parseExternal(CParser *P, NodeFn fn, void *ctx) {
+    if (accept(P, ";")) return;
+    cJSON *one = NULL;
+    if (cur(P)->kind == TK_PRAGMA) one = mkPragma(advance(P));
+    else if (is(P, "_Static_assert")) one = parseStaticAssert(P);
+    if (one) {
+        if (!fn(one, ctx)) cJSON_Delete(one);
+        return;
+    }
+
+    int start = P->pos;
+    Spec sp;
+    parseSpec(P, &sp, 1);
+    if (!is(P, ";")) {
+        Declr d;
+        parseDeclarator(P, &d, 0);
+        int isFunc = d.n && !strcmp(astType(d.mods[0]), "FuncDecl");
+        if (isFunc && (is(P, "{") || isDeclStart(P, cur(P)))) {
+            cJSON *def = mk("FuncDef", d.name);
+            put(def, "decl", buildDecl(P, &sp, &d, NULL, NULL));
+            // K&R 정의: 선언자와 본문 사이의 선언들이 파라미터 타입
+            cJSON *pdecls = cJSON_CreateArray();
+            scopePush(P);
+            while (!is(P, "{")) {
+                if (!isDeclStart(P, cur(P))) cError(P, cur(P), "'{' 필요");
+                parseDeclaration(P, pdecls);
+            }
+            scopePop(P);
+            putKids(def, "param_decls", pdecls);
+            put(def, "body", parseCompound(P, OBJ(d.mods[0], "args")));
+            cJSON_Delete(sp.tag);
+            if (!fn(def, ctx)) cJSON_Delete(def);
+            return;
+        }
+        // 함수 정의가 아니면 일반 선언으로 처음부터 다시 읽는다
+        // (선언자마다 별도 노드가 필요하다)
+        cJSON_Delete(sp.tag);
+        for (int i = 0; i < d.n; i++) cJSON_Delete(d.mods[i]);
+        cJSON_Delete(d.td);
+    } else {
+        cJSON_Delete(sp.tag);
+    }
+
+    P->pos = start;
+    cJSON *list = cJSON_CreateArray();
+    parseDeclaration(P, list);
+    while (ARR_SIZE(list)) {
+        cJSON *n = cJSON_DetachItemFromArray(list, 0);
+        if (!fn(n, ctx)) cJSON_Delete(n);
+    }
+    cJSON_Delete(list);
+}
+
+// 전처리된 C 파일을 파싱하며 최상위 항목마다 fn 호출. 실패 시 0
+int parseCFile(const char *path, NodeFn fn, void *ctx) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        perror(path);
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    long sz = ftell(fp);
+    rewind(fp);
+    char *src = malloc(sz + 1);
+    size_t n = fread(src, 1, sz, fp);
+    fclose(fp);
+
+    CParser P = {0};
+    mapPut(&P.typedefs, "__builtin_va_list", 1);
+    int ok = cLex(&P, src, n, path);
+    free(src);
+
+    if (ok && !setjmp(P.fail)) {
+        while (cur(&P)->kind != TK_EOF) parseExternal(&P, fn, ctx);
+    } else {
+        ok = 0; // 오류 시 만들다 만 노드는 회수하지 않는다
+    }
+
+    free(P.toks);
+    free(P.text);
+    mapFree(&P.typedefs);
+    free(P.undoNames);
+    free(P.undoVals);
+    free(P.scopes);
+    return ok;
+}
+
+// .c/.i는 네이티브 프론트엔드, 나머지는 pycparser JSON
+int isCSource(const char *path) {
+    const char *dot = strrchr(path, '.');
+    return dot && (!strcmp(dot, ".c") || !strcmp(dot, ".i"));
+}
+
+// 입력 종류에 맞춰 최상위 항목을 fn에 넘긴다. 오류는 직접 출력하고 0 반환
+int loadExt(const char *path, NodeFn fn, void *ctx) {
+    if (isCSource(path)) return parseCFile(path, fn, ctx);
+
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        perror(path);
+        return 0;
+    }
+    int ok = streamExt(fp, fn, ctx);
+    fclose(fp);
+    if (!ok) fprintf(stderr, "%s: JSON 파싱 실패\n", path);
+    return ok;
+}
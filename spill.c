@@ -0,0 +1,424 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "analyzer.h"
+
+// ===== 메모리 예산 모드 =====
+// -m으로 예산을 주면 ext 항목을 하나씩 분석한 뒤 Func와 전역 부작용 요약(직접
+// 읽고 쓰는 전역, 호출하는 함수 이름), 클론 스케치를 바로 레코드로 바꿔 버퍼에
+// 쌓고, 버퍼가 예산의 1/4을 넘으면 임시 파일로 내보낸다. 호출 그래프 전파는 임시
+// 파일 끝에 둔 함수별 전역 집합을 읽고 쓰며 하고, 출력도 파일을 창 단위로 읽는다.
+// 메모리에 남는 것은 전역/타입 테이블과 함수·클론 단위마다 수십 바이트의 색인뿐이다.
+size_t bufPut(ByteBuf *b, const void *src, size_t n) {
+    size_t at = b->len;
+    if (b->len + n + 8 > b->cap) {
+        while (b->len + n + 8 > b->cap) b->cap = b->cap ? b->cap * 2 : 4096;
+        b->p = realloc(b->p, b->cap);
+    }
+    if (src) memcpy(b->p + b->len, src, n);
+    else memset(b->p + b->len, 0, n);
+    b->len += n;
+    return at;
+}
+
+static void bufAlign(ByteBuf *b) {
+    if (b->len % 8) bufPut(b, NULL, 8 - b->len % 8);
+}
+
+#define SPILL_WINDOW (64 * 1024)    // 읽기 창 크기
+
+// 레코드: FuncRec, 파라미터 타입 argc개, 직접 읽는/쓰는 전역 id, 이름과 파라미터 이름들,
+// 직접 호출하는 함수 이름들 (문자열은 NUL 끝), 8바이트 정렬
+typedef struct {
+    uint32_t size;
+    int32_t type, retType, ifs, defined, argc;
+    int32_t nrd, nwr, ncallees, pad;
+} FuncRec;
+
+typedef struct {
+    size_t budget;      // 0이면 예산 모드 아님
+    SpillFile funcs;    // Func 레코드. 전파 단계에서 그 뒤에 전역 집합 구역
+    SpillFile clones;   // 클론 스케치 레코드: 스케치, 함수 이름, 위치
+    int cnt;
+    int words;          // 전역 집합 하나(rd 또는 wr)의 워드 수
+    uint64_t sets;      // 전역 집합 구역 위치 (정의 레코드 순서로 rd, wr)
+    int failed;         // 임시 파일 읽기 실패
+} Spill;
+
+static Spill spill = {0, SPILL_FILE_INIT, SPILL_FILE_INIT, 0, 0, 0, 0};
+
+void spillSetBudget(size_t bytes) {
+    spill.budget = bytes;
+}
+
+size_t spillBudget(void) {
+    return spill.budget;
+}
+
+int spillFailed(void) {
+    return spill.failed;
+}
+
+// mem이 이만큼 차면 내보낸다. 예산 모드가 아니면 내보내지 않는다
+static size_t spillChunk(void) {
+    return spill.budget ? spill.budget / 4 : SIZE_MAX;
+}
+
+static int spillFlush(SpillFile *f) {
+    if (!f->mem.len) return 1;
+    if (f->fd < 0) {
+        const char *dir = getenv("TMPDIR");
+        char tmpl[512];
+        snprintf(tmpl, sizeof(tmpl), "%s/analyzer-spill-XXXXXX", dir && *dir ? dir : "/tmp");
+        f->fd = mkstemp(tmpl);
+        if (f->fd < 0) {
+            perror(tmpl);
+            return 0;
+        }
+        unlink(tmpl); // 닫히면 사라진다
+    }
+    if (pwrite(f->fd, f->mem.p, f->mem.len, f->len) != (ssize_t)f->mem.len) {
+        perror("임시 파일 쓰기 실패");
+        return 0;
+    }
+    f->len += f->mem.len;
+    f->mem.len = 0;
+    return 1;
+}
+
+// 끝에 덧붙이고 그 위치를 돌려준다
+uint64_t spillPut(SpillFile *f, const void *src, size_t n) {
+    return f->len + bufPut(&f->mem, src, n);
+}
+
+int spillFull(SpillFile *f) {
+    return f->mem.len < spillChunk() || spillFlush(f);
+}
+
+// off부터 n바이트를 dst로 복사 (창은 건드리지 않는다)
+int spillPread(SpillFile *f, void *dst, size_t n, uint64_t off) {
+    if (off < f->len) {
+        size_t k = off + n <= f->len ? n : f->len - off;
+        if (pread(f->fd, dst, k, off) != (ssize_t)k) return 0;
+        dst = (uint8_t *)dst + k;
+        off += k;
+        n -= k;
+    }
+    memcpy(dst, f->mem.p + (off - f->len), n);
+    return 1;
+}
+
+// off부터 n바이트를 가리키는 포인터. 다음 spillRead 전까지만 유효.
+// 실패하면 spill.failed를 세우고 0으로 채운 창을 돌려준다
+static const uint8_t *spillRead(SpillFile *f, uint64_t off, size_t n) {
+    if (off >= f->len) return f->mem.p + (off - f->len);
+    if (off < f->winAt || off + n > f->winAt + f->win.len) {
+        uint64_t avail = f->len + f->mem.len - off;
+        size_t want = n > SPILL_WINDOW ? n : SPILL_WINDOW;
+        if (want > avail) want = avail;
+        f->win.len = 0;
+        bufPut(&f->win, NULL, want > n ? want : n);
+        f->winAt = off;
+        if (!spillPread(f, f->win.p, want, off)) {
+            if (!spill.failed) perror("임시 파일 읽기 실패");
+            spill.failed = 1;
+            memset(f->win.p, 0, f->win.len);
+        }
+    }
+    return f->win.p + (off - f->winAt);
+}
+
+// 비트셋의 켜진 비트 번호를 uint32로 덧붙이고 개수를 돌려준다
+static int bitsPut(ByteBuf *b, const Bits *s) {
+    int n = 0;
+    for (int i = 0; i < s->n; i++) {
+        for (uint64_t w = s->w[i]; w; w &= w - 1, n++) {
+            uint32_t g = i * 64 + __builtin_ctzll(w);
+            bufPut(b, &g, sizeof(g));
+        }
+    }
+    return n;
+}
+
+static int spillFunc(const Func *f, const Effects *e) {
+    ByteBuf *m = &spill.funcs.mem;
+    FuncRec r = {0, f->type, f->retType, f->ifs, f->defined, f->argc, 0, 0, 0, 0};
+    size_t at = bufPut(m, &r, sizeof(r));
+    for (int i = 0; i < f->argc; i++) bufPut(m, &f->args[i].type, sizeof(int32_t));
+    if (e) {
+        r.nrd = bitsPut(m, &e->rd);
+        r.nwr = bitsPut(m, &e->wr);
+    }
+    bufPut(m, f->name, strlen(f->name) + 1);
+    for (int i = 0; i < f->argc; i++) bufPut(m, f->args[i].name, strlen(f->args[i].name) + 1);
+    for (int i = 0; e && i < e->ncallees; i++) {
+        int c = e->callees[i], dup = 0;
+        for (int j = 0; j < i && !dup; j++) dup = e->callees[j] == c;
+        if (dup) continue;
+        bufPut(m, effs[c].name, strlen(effs[c].name) + 1);
+        r.ncallees++;
+    }
+    bufAlign(m);
+    r.size = m->len - at;
+    memcpy(m->p + at, &r, sizeof(r));
+    spill.cnt++;
+    return spillFull(&spill.funcs);
+}
+
+// 이번 ext에서 만든 클론 단위의 스케치와 출력용 문자열을 내보낸다.
+// 싱글이 CLONE_MIN_SHINGLES보다 적은 단위는 비교 대상이 아니고 그 안쪽 단위는
+// 더 적으므로 메타데이터까지 버린다 (남는 단위의 부모는 항상 남는다)
+static int spillClones(void) {
+    ByteBuf *m = &spill.clones.mem;
+    int *renum = malloc((cloneCnt - cloneBase + 1) * sizeof(int));
+    int n = cloneBase;
+    for (int u = cloneBase; u < cloneCnt; u++) {
+        CloneUnit c = cloneUnits[u];
+        renum[u - cloneBase] = n;
+        if (c.nshingles >= CLONE_MIN_SHINGLES) {
+            c.rec = spillPut(&spill.clones, cloneMh[u - cloneBase], sizeof(*cloneMh));
+            bufPut(m, c.func, strlen(c.func) + 1);
+            bufPut(m, c.coord, strlen(c.coord) + 1);
+            bufAlign(m);
+        }
+        free(c.func);
+        free(c.coord);
+        if (c.nshingles < CLONE_MIN_SHINGLES) continue;
+        c.func = c.coord = NULL;
+        if (c.parent >= 0) c.parent = renum[c.parent - cloneBase];
+        cloneUnits[n++] = c;
+    }
+    free(renum);
+    cloneCnt = cloneBase = n;
+    return spillFull(&spill.clones);
+}
+
+const uint64_t *spillSketch(int u, uint64_t *buf) {
+    memcpy(buf, spillRead(&spill.clones, cloneUnits[u].rec, sizeof(*cloneMh)), sizeof(*cloneMh));
+    return buf;
+}
+
+void spillCloneWhere(int u, const char **func, const char **coord) {
+    // 레코드는 단위 순서로 붙어 있으므로 다음 단위 위치까지가 이 레코드
+    SpillFile *f = &spill.clones;
+    uint64_t end = u + 1 < cloneBase ? cloneUnits[u + 1].rec : f->len + f->mem.len;
+    const char *p = (const char *)spillRead(f, cloneUnits[u].rec, end - cloneUnits[u].rec);
+    *func = p + sizeof(*cloneMh);
+    *coord = *func + strlen(*func) + 1;
+}
+
+// 예산 모드의 ext 콜백: 분석 직후 Func, 부작용 요약, 클론 스케치를 레코드로 옮긴다
+int analyzeSpill(cJSON *node, void *ctx) {
+    int *ok = ctx;
+    if (!*ok) return 0; // 이미 임시 파일 쓰기에 실패했으면 나머지는 건너뛴다
+    visitExt(node);
+    for (int i = 0; i < funcCnt; i++) {
+        if (!spillFunc(&funcs[i], funcs[i].defined ? effectsOf(funcs[i].name) : NULL)) *ok = 0;
+        freeFunc(&funcs[i]);
+    }
+    funcCnt = 0;
+    effReset();
+    if (!spillClones()) *ok = 0;
+    return 0;
+}
+
+int resultCnt(void) {
+    return spill.budget ? spill.cnt : funcCnt;
+}
+
+// 분석 결과를 순서대로 하나씩. f의 문자열은 원본(또는 읽기 창)을 가리킨다
+int funcNext(FuncIter *it, Func *f) {
+    if (!spill.budget) {
+        if (it->i >= funcCnt) return 0;
+        *f = funcs[it->i++];
+        return 1;
+    }
+    if (it->i >= spill.cnt || spill.failed) return 0;
+
+    const FuncRec *r = (const FuncRec *)spillRead(&spill.funcs, it->off, sizeof(FuncRec));
+    r = (const FuncRec *)spillRead(&spill.funcs, it->off, r->size);
+    if (spill.failed) return 0;
+    const int32_t *argTypes = (const int32_t *)(r + 1);
+    char *s = (char *)(argTypes + r->argc + r->nrd + r->nwr);
+
+    memset(f, 0, sizeof(Func));
+    f->type = r->type;
+    f->retType = r->retType;
+    f->ifs = r->ifs;
+    f->defined = r->defined;
+    f->argc = r->argc;
+    f->name = s;
+    s += strlen(s) + 1;
+    for (int i = 0; i < r->argc; i++) {
+        f->args[i].type = argTypes[i];
+        f->args[i].name = s;
+        s += strlen(s) + 1;
+    }
+    it->rec = it->off;
+    it->set = r->defined ? it->defs++ : -1;
+    it->off += r->size;
+    it->i++;
+    return 1;
+}
+
+typedef struct {
+    uint64_t hash;
+    int set;
+} DefKey;
+
+static int cmpDefKey(const void *a, const void *b) {
+    const DefKey *x = a, *y = b;
+    if (x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+    return x->set - y->set;
+}
+
+// 레코드 위치 rec의 함수 이름이 name인지 (창은 건드리지 않는다)
+static int spillNameIs(uint64_t rec, const char *name) {
+    FuncRec r;
+    size_t len = strlen(name) + 1;
+    char buf[256], *s = len <= sizeof(buf) ? buf : malloc(len);
+    int ok = spillPread(&spill.funcs, &r, sizeof(r), rec) &&
+             spillPread(&spill.funcs, s, len, rec + sizeof(r) + 4 * (uint64_t)(r.argc + r.nrd + r.nwr)) &&
+             !memcmp(s, name, len);
+    if (s != buf) free(s);
+    return ok;
+}
+
+static int spillSetIo(int write, uint64_t *w, int set) {
+    size_t n = 2 * spill.words * sizeof(uint64_t);
+    uint64_t at = spill.sets + (uint64_t)set * n;
+    if (write) return pwrite(spill.funcs.fd, w, n, at) == (ssize_t)n;
+    return spillPread(&spill.funcs, w, n, at);
+}
+
+// 예산 모드의 전파. 정의 레코드마다 직접 집합을 임시 파일 끝에 쓰고, 호출 이름을
+// 집합 번호로 바꾼 간선만 메모리에 올려 propagateEffects와 같은 워크리스트로 돈다
+int spillPropagate(void) {
+    SpillFile *f = &spill.funcs;
+    spill.words = (globalCnt + 63) / 64;
+    if (!spillFlush(f)) return 0;
+    spill.sets = f->len;
+
+    // 1. 정의 레코드 색인: 이름 해시 -> 집합 번호
+    DefKey *keys = NULL;
+    uint64_t *recs = NULL;
+    int ndefs = 0, nrecs = 0, keyCap = 0, recCap = 0;
+    FuncIter it = {0};
+    for (Func fn; funcNext(&it, &fn);) {
+        if (it.set < 0) continue;
+        PUSH(keys, ndefs, keyCap, ((DefKey){hashStr(fn.name), it.set}));
+        PUSH(recs, nrecs, recCap, it.rec);
+    }
+    if (ndefs) qsort(keys, ndefs, sizeof(DefKey), cmpDefKey);
+
+    // 2. 직접 집합을 구역에 쓰고 호출 간선 (피호출자, 호출자) 수집
+    size_t setBytes = 2 * spill.words * sizeof(uint64_t);
+    uint64_t *a = calloc(2 * spill.words + 1, sizeof(uint64_t));
+    uint64_t *b = calloc(2 * spill.words + 1, sizeof(uint64_t));
+    int *edges = NULL, nedges = 0, edgeCap = 0;
+    int ok = 1;
+    it = (FuncIter){0};
+    for (Func fn; ok && funcNext(&it, &fn);) {
+        if (it.set < 0) continue;
+        const FuncRec *r = (const FuncRec *)spillRead(f, it.rec, sizeof(FuncRec));
+        r = (const FuncRec *)spillRead(f, it.rec, r->size);
+        const uint32_t *ids = (const uint32_t *)(r + 1) + r->argc;
+        memset(a, 0, setBytes);
+        for (int i = 0; i < r->nrd + r->nwr; i++) {
+            uint32_t g = ids[i] + (i < r->nrd ? 0 : spill.words * 64);
+            a[g / 64] |= 1ULL << (g % 64);
+        }
+        spillPut(f, a, setBytes);
+        ok = spillFull(f);
+
+        const char *s = (const char *)(ids + r->nrd + r->nwr);
+        for (int i = 0; i <= r->argc; i++) s += strlen(s) + 1;
+        for (int i = 0; i < r->ncallees; i++, s += strlen(s) + 1) {
+            DefKey k = {hashStr(s), -1};
+            int lo = 0, hi = ndefs;
+            while (lo < hi) {
+                int mid = (lo + hi) / 2;
+                if (cmpDefKey(&keys[mid], &k) < 0) lo = mid + 1;
+                else hi = mid;
+            }
+            for (; lo < ndefs && keys[lo].hash == k.hash; lo++) {
+                if (!spillNameIs(recs[keys[lo].set], s)) continue;
+                PUSH(edges, nedges, edgeCap, keys[lo].set);
+                PUSH(edges, nedges, edgeCap, it.set);
+            }
+        }
+    }
+    free(keys);
+    free(recs);
+    ok = ok && !spill.failed && spillFlush(f);
+
+    // 3. 피호출자별 호출자 (CSR)
+    nedges /= 2;
+    int *ncallers = calloc(ndefs + 1, sizeof(int));
+    int *callers = malloc((nedges + 1) * sizeof(int));
+    int *fill = calloc(ndefs + 1, sizeof(int));
+    for (int e = 0; e < nedges; e++) ncallers[edges[2 * e] + 1]++;
+    for (int g = 0; g < ndefs; g++) ncallers[g + 1] += ncallers[g];
+    for (int e = 0; e < nedges; e++) {
+        int g = edges[2 * e];
+        callers[ncallers[g] + fill[g]++] = edges[2 * e + 1];
+    }
+    free(edges);
+    free(fill);
+
+    int *work = malloc((ndefs + 1) * sizeof(int));
+    char *queued = malloc(ndefs + 1);
+    int top = 0;
+    for (int g = 0; g < ndefs; g++) {
+        work[top++] = g;
+        queued[g] = 1;
+    }
+    while (ok && spill.words && top) {
+        int g = work[--top];
+        queued[g] = 0;
+        if (ncallers[g] == ncallers[g + 1]) continue;
+        ok = spillSetIo(0, a, g);
+        for (int i = ncallers[g]; ok && i < ncallers[g + 1]; i++) {
+            int c = callers[i];
+            if (!(ok = spillSetIo(0, b, c))) break;
+            uint64_t changed = 0;
+            for (int k = 0; k < 2 * spill.words; k++) {
+                changed |= a[k] & ~b[k];
+                b[k] |= a[k];
+            }
+            if (!changed) continue;
+            ok = spillSetIo(1, b, c);
+            if (!queued[c]) {
+                work[top++] = c;
+                queued[c] = 1;
+            }
+        }
+    }
+    if (!ok) perror("전역 집합 전파 실패");
+
+    free(ncallers);
+    free(callers);
+    free(work);
+    free(queued);
+    free(a);
+    free(b);
+    return ok;
+}
+
+// 함수의 전파된 전역 부작용. 정의가 아니면 NULL.
+// 예산 모드에서는 임시 파일에서 읽어 다음 호출 전까지만 유효
+const Effects *funcEffects(const FuncIter *it, const Func *f) {
+    if (!spill.budget) return f->defined ? effectsOf(f->name) : NULL;
+    if (it->set < 0) return NULL;
+    static Effects e;
+    static uint64_t *w;
+    if (!w) w = calloc(2 * spill.words + 1, sizeof(uint64_t));
+    if (spill.words && !spillSetIo(0, w, it->set)) {
+        if (!spill.failed) perror("임시 파일 읽기 실패");
+        spill.failed = 1;
+        memset(w, 0, 2 * spill.words * sizeof(uint64_t));
+    }
+    e.rd = (Bits){w, spill.words};
+    e.wr = (Bits){w + spill.words, spill.words};
+    return &e;
+}
@@ -0,0 +1,416 @@
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include "analyzer.h"
+
+// ===== 결과 저장소 (열 지향) =====
+// 실행마다 입력 파일 하나를 row group 하나로 파일 끝에 덧붙인다.
+// row group = 헤더, 열 목록, 열 데이터(uint32 배열), 문자열 사전, 꼬리표.
+// 문자열 열은 사전 id로 저장하고, 모든 구역은 8바이트 정렬이라 mmap한 포인터를
+// 그대로 배열로 읽을 수 있다. 꼬리표가 없는(쓰다 끊긴) 마지막 row group은
+// 읽을 때 무시하고 다음 추가 때 잘라낸다.
+#define STORE_MAGIC "WHSCOL1"
+#define RG_MAGIC "RGRP"
+#define RG_END "RGEND"
+
+enum { COL_U32, COL_STR };
+
+typedef struct {
+    char magic[4];
+    uint32_t rows, ncols, ndict;
+    uint32_t file;      // 입력 파일 이름 (사전 id)
+    uint32_t pad;
+    uint64_t size;      // 꼬리표까지 포함한 row group 크기
+    uint64_t dictOff;   // row group 시작 기준 사전 위치
+} RowGroup;
+
+typedef struct {
+    char name[16];
+    uint32_t kind;
+    uint32_t pad;
+    uint64_t off;       // row group 시작 기준 열 데이터 위치
+} ColDesc;
+
+typedef struct {
+    uint64_t size;      // RowGroup.size와 같아야 한다
+    char magic[8];
+} RowGroupEnd;
+
+typedef struct {
+    const char *name;
+    int kind;
+} ColSpec;
+
+// 열 순서는 저장소 포맷의 일부. 새 열은 끝에 추가한다
+static const ColSpec storeCols[] = {
+    {"name", COL_STR},
+    {"type", COL_STR},       // 함수 시그니처
+    {"ret_type", COL_STR},   // 반환 타입 (타입 id는 실행마다 달라서 렌더링한 문자열)
+    {"argc", COL_U32},
+    {"ifs", COL_U32},
+    {"defined", COL_U32},
+    {"gl_reads", COL_U32},   // 전파 후 읽는 전역 수
+    {"gl_writes", COL_U32},
+};
+#define STORE_NCOLS (int)(sizeof(storeCols) / sizeof(storeCols[0]))
+
+// 문자열 사전. 문자열은 나온 순서대로 strs(예산 모드에서는 임시 파일)에 쌓고,
+// 메모리에는 해시 색인과 시작 위치만 둔다
+typedef struct {
+    uint64_t hash;
+    uint32_t id;        // id + 1, 0이면 빈칸
+} DictSlot;
+
+typedef struct {
+    DictSlot *slots;
+    int cap;
+    uint32_t *offs;     // 문자열 시작 위치 cnt+1개 (마지막은 전체 길이)
+    int cnt, offCap;
+    SpillFile strs;
+    int failed;
+} StrDict;
+
+static void dictGrow(StrDict *d) {
+    DictSlot *old = d->slots;
+    int oldCap = d->cap;
+    d->cap = oldCap ? oldCap * 2 : 256;
+    d->slots = calloc(d->cap, sizeof(DictSlot));
+    for (int i = 0; i < oldCap; i++) {
+        if (!old[i].id) continue;
+        size_t j = old[i].hash & (d->cap - 1);
+        while (d->slots[j].id) j = (j + 1) & (d->cap - 1);
+        d->slots[j] = old[i];
+    }
+    free(old);
+}
+
+static uint32_t dictId(StrDict *d, const char *s) {
+    uint32_t len = strlen(s) + 1;
+    uint64_t h = hashStr(s);
+    if ((d->cnt + 1) * 2 > d->cap) dictGrow(d);
+    size_t i = h & (d->cap - 1);
+    for (; d->slots[i].id; i = (i + 1) & (d->cap - 1)) {
+        uint32_t id = d->slots[i].id - 1;
+        if (d->slots[i].hash != h || d->offs[id + 1] - d->offs[id] != len) continue;
+        // 해시와 길이가 같으면 저장된 문자열과 실제로 비교
+        char buf[256], *t = len <= sizeof(buf) ? buf : malloc(len);
+        int eq = spillPread(&d->strs, t, len, d->offs[id]) && !memcmp(t, s, len);
+        if (t != buf) free(t);
+        if (eq) return id;
+    }
+    d->slots[i] = (DictSlot){h, d->cnt + 1};
+    spillPut(&d->strs, s, len);
+    if (!spillFull(&d->strs)) d->failed = 1;
+    if (d->cnt + 2 > d->offCap) {
+        d->offCap = d->offCap ? d->offCap * 2 : 256;
+        d->offs = realloc(d->offs, d->offCap * sizeof(uint32_t));
+    }
+    if (!d->cnt) d->offs[0] = 0;
+    d->offs[d->cnt + 1] = d->offs[d->cnt] + len;
+    return d->cnt++;
+}
+
+static void dictFree(StrDict *d) {
+    free(d->slots);
+    free(d->offs);
+    free(d->strs.mem.p);
+    free(d->strs.win.p);
+    if (d->strs.fd >= 0) close(d->strs.fd);
+}
+
+static uint32_t bitCount(const Bits *b) {
+    uint32_t n = 0;
+    for (int i = 0; i < b->n; i++) n += __builtin_popcountll(b->w[i]);
+    return n;
+}
+
+static uint32_t colValue(const FuncIter *it, const Func *f, int col, StrDict *d) {
+    const Effects *e = funcEffects(it, f);
+    switch (col) {
+    case 0: return dictId(d, f->name);
+    case 1: return dictId(d, typeStr(f->type));
+    case 2: return dictId(d, typeStr(f->retType));
+    case 3: return f->argc;
+    case 4: return f->ifs;
+    case 5: return f->defined;
+    case 6: return e ? bitCount(&e->rd) : 0;
+    case 7: return e ? bitCount(&e->wr) : 0;
+    }
+    return 0;
+}
+
+#define STORE_CHUNK (64 * 1024)
+
+// b를 파일의 *pos에 쓰고 비운다
+static int bufDrain(ByteBuf *b, int fd, uint64_t *pos) {
+    int ok = pwrite(fd, b->p, b->len, *pos) == (ssize_t)b->len;
+    *pos += b->len;
+    b->len = 0;
+    return ok;
+}
+
+// 현재 결과를 row group 하나로 fd의 at 위치에 쓴다. 열 값은 조금씩 모아 바로 쓰고,
+// 헤더와 열 목록은 크기가 정해진 뒤에, 꼬리표는 맨 마지막에 쓴다
+static int writeRowGroup(int fd, uint64_t at, const char *input) {
+    StrDict d = {0};
+    d.strs = (SpillFile)SPILL_FILE_INIT;
+    RowGroup g = {RG_MAGIC, (uint32_t)resultCnt(), STORE_NCOLS, 0, dictId(&d, input), 0, 0, 0};
+    ColDesc cols[STORE_NCOLS];
+    memset(cols, 0, sizeof(cols));
+
+    ByteBuf b = {0};
+    uint64_t pos = at + sizeof(g) + sizeof(cols);
+    int ok = 1;
+    for (int c = 0; c < STORE_NCOLS; c++) {
+        strncpy(cols[c].name, storeCols[c].name, sizeof(cols[c].name) - 1);
+        cols[c].kind = storeCols[c].kind;
+        cols[c].off = pos - at;
+        FuncIter it = {0};
+        for (Func f; funcNext(&it, &f);) {
+            uint32_t v = colValue(&it, &f, c, &d);
+            bufPut(&b, &v, sizeof(v));
+            if (b.len >= STORE_CHUNK) ok &= bufDrain(&b, fd, &pos);
+        }
+        if ((pos + b.len) % 8) bufPut(&b, NULL, 8 - (pos + b.len) % 8);
+        ok &= bufDrain(&b, fd, &pos);
+    }
+
+    // 사전: 오프셋 ndict+1개, 이어서 NUL로 끝나는 문자열들
+    g.ndict = d.cnt;
+    g.dictOff = pos - at;
+    bufPut(&b, d.offs, (d.cnt + 1) * sizeof(uint32_t));
+    ok &= bufDrain(&b, fd, &pos);
+    for (uint32_t o = 0, total = d.offs[d.cnt]; o < total;) {
+        uint32_t n = total - o < STORE_CHUNK ? total - o : STORE_CHUNK;
+        bufPut(&b, NULL, n);
+        ok &= spillPread(&d.strs, b.p, n, o);
+        ok &= bufDrain(&b, fd, &pos);
+        o += n;
+    }
+    if (pos % 8) bufPut(&b, NULL, 8 - pos % 8);
+    ok &= bufDrain(&b, fd, &pos);
+
+    RowGroupEnd end = {pos - at + sizeof(RowGroupEnd), RG_END};
+    g.size = end.size;
+    uint64_t head = at;
+    bufPut(&b, &g, sizeof(g));
+    bufPut(&b, cols, sizeof(cols));
+    ok &= bufDrain(&b, fd, &head);
+    bufPut(&b, &end, sizeof(end));
+    ok &= bufDrain(&b, fd, &pos);
+
+    ok &= !d.failed && !spillFailed();
+    free(b.p);
+    dictFree(&d);
+    return ok;
+}
+
+// row group 경계가 온전한지 (꼬리표 확인)
+static int rgValid(const uint8_t *p, uint64_t avail) {
+    const RowGroup *g = (const RowGroup *)p;
+    if (avail < sizeof(RowGroup) || memcmp(g->magic, RG_MAGIC, 4)) return 0;
+    if (g->size % 8 || g->size > avail || g->size < sizeof(RowGroup) + sizeof(RowGroupEnd)) return 0;
+    const RowGroupEnd *e = (const RowGroupEnd *)(p + g->size - sizeof(RowGroupEnd));
+    return e->size == g->size && !strncmp(e->magic, RG_END, sizeof(e->magic));
+}
+
+// 결과를 저장소 끝에 덧붙인다. 같은 저장소에 동시에 쓰는 프로세스는 flock으로 순서를 맞춘다
+int storeAppend(const char *path, const char *input) {
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        perror(path);
+        return 0;
+    }
+    struct stat st;
+    if (flock(fd, LOCK_EX) || fstat(fd, &st)) {
+        perror(path);
+        close(fd);
+        return 0;
+    }
+    // 빈 파일이나 저장소 헤더로 시작하는 파일에만 쓴다 (다른 파일을 잘라내지 않도록)
+    char magic[sizeof(STORE_MAGIC)];
+    uint64_t end = st.st_size;
+    size_t head = end < sizeof(magic) ? end : sizeof(magic);
+    if (head && (pread(fd, magic, head, 0) != (ssize_t)head || memcmp(magic, STORE_MAGIC, head))) {
+        fprintf(stderr, "%s: 결과 저장소가 아님\n", path);
+        flock(fd, LOCK_UN);
+        close(fd);
+        return 0;
+    }
+    if (end < sizeof(STORE_MAGIC)) {
+        end = 0; // 새 파일 (또는 헤더도 못 쓴 파일)
+    } else {
+        // 마지막 row group의 꼬리표가 깨졌으면 온전한 곳까지 되돌아간다
+        RowGroupEnd tail;
+        int torn = pread(fd, &tail, sizeof(tail), end - sizeof(tail)) != sizeof(tail) ||
+                   strncmp(tail.magic, RG_END, sizeof(tail.magic)) || tail.size > end - sizeof(STORE_MAGIC);
+        if (end == sizeof(STORE_MAGIC)) torn = 0;
+        if (torn) {
+            void *m = mmap(NULL, end, PROT_READ, MAP_PRIVATE, fd, 0);
+            uint64_t ok = sizeof(STORE_MAGIC);
+            if (m != MAP_FAILED) {
+                while (rgValid((uint8_t *)m + ok, end - ok)) ok += ((const RowGroup *)((uint8_t *)m + ok))->size;
+                munmap(m, end);
+            }
+            end = ok;
+        }
+    }
+
+    int ok = ftruncate(fd, end) == 0;
+    if (ok && !end) {
+        ok = pwrite(fd, STORE_MAGIC, sizeof(STORE_MAGIC), 0) == sizeof(STORE_MAGIC);
+        end = sizeof(STORE_MAGIC);
+    }
+    ok = ok && writeRowGroup(fd, end, input);
+    if (!ok) perror(path);
+    flock(fd, LOCK_UN);
+    close(fd);
+    return ok;
+}
+
+typedef struct {
+    const uint8_t *base;
+    size_t size;
+} ColStore;
+
+int storeOpen(const char *path, ColStore *s) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return 0;
+    }
+    struct stat st;
+    fstat(fd, &st);
+    s->size = st.st_size;
+    s->base = s->size ? mmap(NULL, s->size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (s->base == MAP_FAILED || s->size < sizeof(STORE_MAGIC) || memcmp(s->base, STORE_MAGIC, sizeof(STORE_MAGIC))) {
+        fprintf(stderr, "%s: 결과 저장소가 아님\n", path);
+        if (s->base != MAP_FAILED) munmap((void *)s->base, s->size);
+        return 0;
+    }
+    return 1;
+}
+
+void storeClose(ColStore *s) {
+    munmap((void *)s->base, s->size);
+}
+
+// 다음 row group (prev가 NULL이면 첫 번째). 끝이거나 깨졌으면 NULL
+const RowGroup *storeNext(const ColStore *s, const RowGroup *prev) {
+    size_t at = prev ? (size_t)((const uint8_t *)prev - s->base) + prev->size : sizeof(STORE_MAGIC);
+    if (!rgValid(s->base + at, s->size - at)) return NULL;
+
+    // 열/사전 위치가 row group 안에 있는지
+    const RowGroup *g = (const RowGroup *)(s->base + at);
+    const ColDesc *cols = (const ColDesc *)(g + 1);
+    uint64_t body = g->size - sizeof(RowGroupEnd);
+    if (sizeof(RowGroup) + (uint64_t)g->ncols * sizeof(ColDesc) > body) return NULL;
+    for (uint32_t c = 0; c < g->ncols; c++) {
+        if (cols[c].off % 4 || cols[c].off + (uint64_t)g->rows * 4 > body) return NULL;
+    }
+    if (g->dictOff % 4 || g->dictOff + ((uint64_t)g->ndict + 1) * 4 > body) return NULL;
+    const uint32_t *offs = (const uint32_t *)((const uint8_t *)g + g->dictOff);
+    if (g->dictOff + (g->ndict + 1) * 4 + (uint64_t)offs[g->ndict] > body) return NULL;
+    return g;
+}
+
+const ColDesc *storeColDesc(const RowGroup *g, const char *name) {
+    const ColDesc *cols = (const ColDesc *)(g + 1);
+    for (uint32_t c = 0; c < g->ncols; c++) {
+        if (!strncmp(cols[c].name, name, sizeof(cols[c].name))) return &cols[c];
+    }
+    return NULL;
+}
+
+const uint32_t *storeColumn(const RowGroup *g, const char *name) {
+    const ColDesc *c = storeColDesc(g, name);
+    return c ? (const uint32_t *)((const uint8_t *)g + c->off) : NULL;
+}
+
+const char *storeStr(const RowGroup *g, uint32_t id) {
+    if (id >= g->ndict) return "?";
+    const uint32_t *offs = (const uint32_t *)((const uint8_t *)g + g->dictOff);
+    return (const char *)(offs + g->ndict + 1) + offs[id];
+}
+
+typedef struct {
+    uint32_t v;
+    const RowGroup *g;
+    uint32_t row;
+} TopEnt;
+
+// 값이 작은 쪽이 위인 힙
+static void topSift(TopEnt *h, int n, int i) {
+    for (;;) {
+        int m = i, l = 2 * i + 1, r = l + 1;
+        if (l < n && h[l].v < h[m].v) m = l;
+        if (r < n && h[r].v < h[m].v) m = r;
+        if (m == i) return;
+        TopEnt t = h[i];
+        h[i] = h[m];
+        h[m] = t;
+        i = m;
+    }
+}
+
+static int cmpTopDesc(const void *a, const void *b) {
+    const TopEnt *x = a, *y = b;
+    return x->v != y->v ? (x->v < y->v ? 1 : -1) : 0;
+}
+
+// 모든 row group에서 열 값이 큰 함수 n개. 필요한 열 두 개만 읽는다
+int storeTop(const char *path, int n, const char *col) {
+    ColStore s;
+    if (!storeOpen(path, &s)) return 1;
+
+    TopEnt *heap = malloc((n > 0 ? n : 1) * sizeof(TopEnt));
+    int cnt = 0, groups = 0, found = 0;
+    for (const RowGroup *g = storeNext(&s, NULL); g; g = storeNext(&s, g)) {
+        groups++;
+        const ColDesc *c = storeColDesc(g, col);
+        if (!c) continue;
+        found = 1;
+        if (c->kind != COL_U32) {
+            // 문자열 열의 값은 사전 id라 크기 순서에 의미가 없다
+            fprintf(stderr, "%s: 숫자 열이 아님\n", col);
+            free(heap);
+            storeClose(&s);
+            return 1;
+        }
+        const uint32_t *v = (const uint32_t *)((const uint8_t *)g + c->off);
+        for (uint32_t r = 0; r < g->rows; r++) {
+            if (cnt < n) {
+                heap[cnt++] = (TopEnt){v[r], g, r};
+                if (cnt == n) {
+                    for (int i = n / 2 - 1; i >= 0; i--) topSift(heap, n, i);
+                }
+            } else if (n > 0 && v[r] > heap[0].v) {
+                heap[0] = (TopEnt){v[r], g, r};
+                topSift(heap, n, 0);
+            }
+        }
+    }
+    // 어느 row group에도 없는 열이면 오타로 본다 (빈 저장소는 확인할 수 없음)
+    if (groups && !found) {
+        fprintf(stderr, "%s: 없는 열\n", col);
+        free(heap);
+        storeClose(&s);
+        return 1;
+    }
+    qsort(heap, cnt, sizeof(TopEnt), cmpTopDesc);
+
+    printf("==== %s 상위 %d개 (row group %d개) ====\n", col, cnt, groups);
+    for (int i = 0; i < cnt; i++) {
+        const uint32_t *names = storeColumn(heap[i].g, "name");
+        printf("%6u  %s  %s\n", heap[i].v, storeStr(heap[i].g, heap[i].g->file),
+               names ? storeStr(heap[i].g, names[heap[i].row]) : "?");
+    }
+    free(heap);
+    storeClose(&s);
+    return 0;
+}